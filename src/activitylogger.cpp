@@ -0,0 +1,216 @@
+#include "activitylogger.h"
+
+#include <QDateTime>
+#include <QThread>
+
+#include <algorithm>
+#include <csignal>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+std::atomic<ActivityLogger *> ActivityLogger::signalTarget{nullptr};
+
+namespace {
+int roundUpToPowerOfTwo(int n)
+{
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Async-signal-safe helpers for the crash handler: no allocation.
+void writeRaw(int fd, const char *data, size_t size)
+{
+#ifdef Q_OS_WIN
+    _write(fd, data, unsigned(size));
+#else
+    while (size > 0) {
+        const ssize_t n = ::write(fd, data, size);
+        if (n <= 0) return;
+        data += n;
+        size -= size_t(n);
+    }
+#endif
+}
+
+size_t formatNumber(qint64 value, char *out)
+{
+    char digits[24];
+    size_t n = 0;
+    quint64 v = value < 0 ? 0 : quint64(value);
+    do {
+        digits[n++] = char('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    for (size_t i = 0; i < n; ++i) out[i] = digits[n - 1 - i];
+    return n;
+}
+
+// UTF-16 to UTF-8 into `out`; stops before a code point that does not fit.
+size_t encodeUtf8(const QChar *s, int length, char *out, size_t capacity)
+{
+    size_t n = 0;
+    for (int i = 0; i < length; ++i) {
+        uint c = s[i].unicode();
+        if (QChar::isHighSurrogate(c) && i + 1 < length && s[i + 1].isLowSurrogate())
+            c = QChar::surrogateToUcs4(ushort(c), s[++i].unicode());
+
+        char buf[4];
+        size_t len;
+        if (c < 0x80) { buf[0] = char(c); len = 1; }
+        else if (c < 0x800) { buf[0] = char(0xC0 | c >> 6); buf[1] = char(0x80 | (c & 0x3F)); len = 2; }
+        else if (c < 0x10000) {
+            buf[0] = char(0xE0 | c >> 12); buf[1] = char(0x80 | (c >> 6 & 0x3F));
+            buf[2] = char(0x80 | (c & 0x3F)); len = 3;
+        } else {
+            buf[0] = char(0xF0 | c >> 18); buf[1] = char(0x80 | (c >> 12 & 0x3F));
+            buf[2] = char(0x80 | (c >> 6 & 0x3F)); buf[3] = char(0x80 | (c & 0x3F)); len = 4;
+        }
+        if (n + len > capacity) break;
+        for (size_t k = 0; k < len; ++k) out[n++] = buf[k];
+    }
+    return n;
+}
+}
+
+ActivityLogger::ActivityLogger(int capacity, int flushIntervalMs)
+    : ring(roundUpToPowerOfTwo(std::max(capacity, 2)))
+    , mask(ring.size() - 1)
+    , flushIntervalMs(flushIntervalMs)
+{
+}
+
+ActivityLogger::~ActivityLogger()
+{
+    close();
+}
+
+bool ActivityLogger::open(const QString &path)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Unbuffered)) return false;
+
+    fd = file.handle();
+    stopping = false;
+    draining = false;
+    writer = std::thread([this]() { run(); });
+
+    // Crashes only; SIGINT / SIGTERM keep their default handling.
+    ActivityLogger *expected = nullptr;
+    if (signalTarget.compare_exchange_strong(expected, this)) {
+        for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGILL})
+            std::signal(sig, &ActivityLogger::onSignal);
+    }
+    return true;
+}
+
+void ActivityLogger::close()
+{
+    if (!writer.joinable()) return;
+
+    stopping = true;
+    wake.release();
+    writer.join();   // the writer drains the ring before it exits
+
+    ActivityLogger *self = this;
+    signalTarget.compare_exchange_strong(self, nullptr);
+    file.close();
+    fd = -1;
+}
+
+void ActivityLogger::log(const QString &message)
+{
+    if (!writer.joinable()) return;
+
+    const quint32 h = head.load(std::memory_order_relaxed);
+    while (h - tail.load(std::memory_order_acquire) > quint32(mask)) {
+        wake.release();
+        QThread::yieldCurrentThread();
+    }
+
+    Record &r = ring[int(h & quint32(mask))];
+    r.msecs = QDateTime::currentMSecsSinceEpoch();
+    r.text = message;
+    head.store(h + 1, std::memory_order_release);
+
+    // Wake the writer early once half the ring is in use.
+    if (h - tail.load(std::memory_order_relaxed) == quint32(ring.size() / 2)) wake.release();
+}
+
+int ActivityLogger::drain(QByteArray &out)
+{
+    const quint32 t = tail.load(std::memory_order_relaxed);
+    const quint32 h = head.load(std::memory_order_acquire);
+
+    for (quint32 i = t; i != h; ++i) {
+        Record &r = ring[int(i & quint32(mask))];
+        const qint64 second = r.msecs / 1000;
+        if (second != prefixSecond) {
+            prefixSecond = second;
+            prefix = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd HH:mm:ss").toUtf8() + " - ";
+        }
+        out += prefix;
+        out += r.text.toUtf8();
+        out += '\n';
+        r.text.clear();
+    }
+    tail.store(h, std::memory_order_release);
+    return int(h - t);
+}
+
+void ActivityLogger::run()
+{
+    QByteArray buffer;
+    for (;;) {
+        wake.tryAcquire(1, flushIntervalMs);
+        const bool last = stopping.load();
+
+        // A crash handler holding the token owns the ring from then on.
+        buffer.clear();
+        if (!draining.exchange(true, std::memory_order_acquire)) {
+            if (drain(buffer) > 0) file.write(buffer);
+            draining.store(false, std::memory_order_release);
+        }
+        if (last) {
+            file.flush();
+            return;
+        }
+    }
+}
+
+void ActivityLogger::emergencyFlush()
+{
+    // The writer is mid-drain: its batch may still land, the ring is not ours.
+    if (fd < 0 || draining.exchange(true, std::memory_order_acquire)) return;
+
+    char line[1024];
+    const quint32 h = head.load(std::memory_order_acquire);
+    for (quint32 i = tail.load(std::memory_order_relaxed); i != h; ++i) {
+        const Record &r = ring.at(int(i & quint32(mask)));
+        size_t n = formatNumber(r.msecs, line);
+        line[n++] = ' ';
+        line[n++] = '-';
+        line[n++] = ' ';
+        n += encodeUtf8(r.text.constData(), r.text.size(), line + n, sizeof(line) - n - 1);
+        line[n++] = '\n';
+        writeRaw(fd, line, n);
+    }
+    tail.store(h, std::memory_order_release);
+
+    static const char marker[] = "-- flushed on crash (times in ms since epoch) --\n";
+    writeRaw(fd, marker, sizeof(marker) - 1);
+}
+
+void ActivityLogger::onSignal(int sig)
+{
+    if (ActivityLogger *logger = signalTarget.exchange(nullptr)) logger->emergencyFlush();
+
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
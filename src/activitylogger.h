@@ -0,0 +1,72 @@
+#ifndef ACTIVITYLOGGER_H
+#define ACTIVITYLOGGER_H
+
+#include <QFile>
+#include <QSemaphore>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <thread>
+
+// Text activity log written off the GUI thread.
+//
+// log() only stamps the record with the current time and pushes it into a
+// lock-free single-producer/single-consumer ring; a writer thread formats
+// the lines (the "yyyy-MM-dd HH:mm:ss" prefix is rebuilt once per second)
+// and writes them in one call per wake-up, every `flushIntervalMs` or as
+// soon as the ring is half full. A full ring makes log() wait for the
+// writer rather than drop records.
+//
+// Everything queued is written on close() and, best effort, when the
+// process crashes (SIGSEGV, SIGABRT, SIGFPE, SIGILL). The crash handler
+// only writes if the writer thread is not draining at that moment (the
+// ring has one consumer at a time) and uses raw write(2) with times in
+// ms since epoch, since nothing else is async-signal-safe.
+//
+// log() must always be called from the same thread (the GUI thread).
+class ActivityLogger
+{
+public:
+    explicit ActivityLogger(int capacity = 8192, int flushIntervalMs = 200);
+    ~ActivityLogger();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return writer.joinable(); }
+    QString fileName() const { return file.fileName(); }
+
+    void log(const QString &message);
+
+private:
+    struct Record {
+        qint64 msecs = 0;
+        QString text;
+    };
+
+    void run();
+    int drain(QByteArray &out);
+    void emergencyFlush();
+    static void onSignal(int sig);
+
+    QVector<Record> ring;
+    const int mask;
+    const int flushIntervalMs;
+    std::atomic<quint32> head{0};   // next slot to fill (producer)
+    std::atomic<quint32> tail{0};   // next slot to drain (consumer)
+
+    QSemaphore wake;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> draining{false};   // consumer token: writer or crash handler
+    std::thread writer;
+    QFile file;
+    int fd = -1;                         // file's descriptor, for the crash handler
+
+    // Writer-side timestamp cache.
+    qint64 prefixSecond = -1;
+    QByteArray prefix;
+
+    static std::atomic<ActivityLogger *> signalTarget;
+};
+
+#endif // ACTIVITYLOGGER_H
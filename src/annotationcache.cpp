@@ -0,0 +1,39 @@
+#include "annotationcache.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+AnnotationCache::AnnotationCache(int maxBoxes)
+{
+    cache.setMaxCost(maxBoxes);
+}
+
+QVector<YoloLabel> AnnotationCache::labelsFor(const QString &imagePath)
+{
+    const QString txtPath = YoloLabels::labelPathFor(imagePath);
+    const QFileInfo fi(txtPath);
+    const qint64 mtime = fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : -1;
+
+    if (const Entry *e = cache.object(imagePath)) {
+        if (e->labelMtime == mtime) return e->labels;
+    }
+
+    Entry *e = new Entry;
+    e->labelMtime = mtime;
+    if (mtime >= 0) YoloLabels::readFile(txtPath, buffer, e->labels);
+    e->labels.squeeze();
+
+    const QVector<YoloLabel> labels = e->labels;
+    cache.insert(imagePath, e, 1 + labels.size());
+    return labels;
+}
+
+void AnnotationCache::invalidate(const QString &imagePath)
+{
+    cache.remove(imagePath);
+}
+
+void AnnotationCache::clear()
+{
+    cache.clear();
+}
@@ -0,0 +1,35 @@
+#ifndef ANNOTATIONCACHE_H
+#define ANNOTATIONCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QString>
+#include <QVector>
+
+#include "yololabels.h"
+
+// Parsed YOLO labels per image, kept in normalized coordinates so they do not
+// depend on the decoded image size. An entry is re-parsed only when the
+// label file's mtime changes.
+class AnnotationCache
+{
+public:
+    explicit AnnotationCache(int maxBoxes = 500000);
+
+    // Labels for `imagePath` (empty if it has no .txt). One stat per call.
+    QVector<YoloLabel> labelsFor(const QString &imagePath);
+
+    void invalidate(const QString &imagePath);
+    void clear();
+
+private:
+    struct Entry {
+        qint64 labelMtime = -1;   // -1: no label file
+        QVector<YoloLabel> labels;
+    };
+
+    QCache<QString, Entry> cache;
+    QByteArray buffer;            // reused by YoloLabels::readFile()
+};
+
+#endif // ANNOTATIONCACHE_H
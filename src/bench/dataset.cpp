@@ -0,0 +1,133 @@
+#include "dataset.h"
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLinearGradient>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QThreadPool>
+
+namespace {
+
+const int kVersion = 1;
+const char *const kManifest = "dataset.json";
+
+QJsonObject manifestFor(const BenchDataset::Spec &spec)
+{
+    QJsonObject o;
+    o["version"] = kVersion;
+    o["images"] = spec.images;
+    o["boxes"] = spec.boxes;
+    o["width"] = spec.size.width();
+    o["height"] = spec.size.height();
+    o["classes"] = spec.classes;
+    return o;
+}
+
+bool writeImage(const QDir &dir, int index, const BenchDataset::Spec &spec)
+{
+    QRandomGenerator rng(quint32(index) * 2654435761u + 1);
+    const int w = spec.size.width();
+    const int h = spec.size.height();
+
+    QImage img(spec.size, QImage::Format_RGB32);
+    QPainter p(&img);
+    QLinearGradient bg(0, 0, w, h);
+    bg.setColorAt(0, QColor::fromHsv(rng.bounded(360), 60, 200));
+    bg.setColorAt(1, QColor::fromHsv(rng.bounded(360), 120, 80));
+    p.fillRect(img.rect(), bg);
+
+    QByteArray labels;
+    labels.reserve(spec.boxes * 48);
+    for (int b = 0; b < spec.boxes; ++b) {
+        const double bw = 0.02 + rng.generateDouble() * 0.25;
+        const double bh = 0.02 + rng.generateDouble() * 0.25;
+        const double xc = bw / 2 + rng.generateDouble() * (1 - bw);
+        const double yc = bh / 2 + rng.generateDouble() * (1 - bh);
+
+        const QRectF r((xc - bw / 2) * w, (yc - bh / 2) * h, bw * w, bh * h);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor::fromHsv(rng.bounded(360), 200, 60 + rng.bounded(190)));
+        if (b % 2) p.drawEllipse(r);
+        else p.drawRect(r);
+
+        labels += QByteArray::number(rng.bounded(spec.classes)) + ' '
+                + QByteArray::number(xc, 'f', 6) + ' ' + QByteArray::number(yc, 'f', 6) + ' '
+                + QByteArray::number(bw, 'f', 6) + ' ' + QByteArray::number(bh, 'f', 6) + ' '
+                + QByteArray::number(0.25 + rng.generateDouble() * 0.75, 'f', 4) + '\n';
+    }
+    p.end();
+
+    const QString name = BenchDataset::imageName(index);
+    if (!img.save(dir.filePath(name), "JPG", 90)) return false;
+
+    QFile txt(dir.filePath(name.left(name.size() - 4) + ".txt"));
+    return txt.open(QIODevice::WriteOnly) && txt.write(labels) == labels.size();
+}
+
+} // namespace
+
+namespace BenchDataset {
+
+QString imageName(int index)
+{
+    return QString("img_%1.jpg").arg(index, 6, 10, QChar('0'));
+}
+
+bool matches(const QString &dir, const Spec &spec)
+{
+    QFile f(QDir(dir).filePath(kManifest));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    return QJsonDocument::fromJson(f.readAll()).object() == manifestFor(spec);
+}
+
+bool generate(const QString &dirPath, const Spec &spec, QString *error)
+{
+    QDir dir(dirPath);
+    if (!dir.mkpath(".")) {
+        if (error) *error = "cannot create " + dirPath;
+        return false;
+    }
+    QFile::remove(dir.filePath(kManifest));
+    for (const QString &name : dir.entryList({"img_*.jpg", "img_*.txt"}, QDir::Files))
+        dir.remove(name);
+
+    QAtomicInt failed(0);
+    QThreadPool pool;
+    for (int i = 0; i < spec.images; ++i) {
+        pool.start([&dir, &spec, &failed, i]() {
+            if (!writeImage(dir, i, spec)) failed.ref();
+        });
+    }
+    pool.waitForDone();
+    if (failed.loadRelaxed() > 0) {
+        if (error) *error = QString("failed to write %1 image(s)").arg(failed.loadRelaxed());
+        return false;
+    }
+
+    QFile names(dir.filePath("classes.names"));
+    if (names.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        for (int c = 0; c < spec.classes; ++c) names.write(QByteArray("class") + QByteArray::number(c) + '\n');
+    }
+
+    QSaveFile manifest(dir.filePath(kManifest));
+    if (!manifest.open(QIODevice::WriteOnly)) return false;
+    manifest.write(QJsonDocument(manifestFor(spec)).toJson());
+    return manifest.commit();
+}
+
+QSize parseSize(const QString &text)
+{
+    const QStringList parts = text.split('x');
+    if (parts.size() != 2) return QSize();
+    bool okW = false, okH = false;
+    const QSize s(parts.at(0).toInt(&okW), parts.at(1).toInt(&okH));
+    return okW && okH && s.width() > 0 && s.height() > 0 ? s : QSize();
+}
+
+} // namespace BenchDataset
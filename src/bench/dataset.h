@@ -0,0 +1,33 @@
+#ifndef BENCH_DATASET_H
+#define BENCH_DATASET_H
+
+#include <QSize>
+#include <QString>
+
+// Synthetic image directory for the benchmarks: `images` JPEGs of `size`
+// pixels, each with a YOLO label file of `boxes` boxes that outline shapes
+// actually drawn into the image, plus a classes.names. Content is seeded by
+// the image index, so the same spec always produces the same files.
+namespace BenchDataset {
+
+struct Spec {
+    int images = 500;
+    int boxes = 20;
+    QSize size = QSize(1920, 1080);
+    int classes = 80;
+};
+
+QString imageName(int index);   // img_000042.jpg
+
+// True if `dir` already holds a dataset generated from `spec`.
+bool matches(const QString &dir, const Spec &spec);
+
+// (Re)generates the dataset into `dir` on all cores.
+bool generate(const QString &dir, const Spec &spec, QString *error = nullptr);
+
+// "1920x1080" -> QSize; invalid on a parse error.
+QSize parseSize(const QString &text);
+
+} // namespace BenchDataset
+
+#endif // BENCH_DATASET_H
@@ -0,0 +1,44 @@
+// Writes a synthetic benchmark dataset (see dataset.h).
+//
+//   gendataset DIR [--images N] [--boxes M] [--size WxH]
+
+#include "dataset.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates N images x M YOLO boxes for the benchmarks.");
+    parser.addHelpOption();
+    const QCommandLineOption imagesOpt("images", "Number of images (default 500).", "N", "500");
+    const QCommandLineOption boxesOpt("boxes", "Boxes per image (default 20).", "M", "20");
+    const QCommandLineOption sizeOpt("size", "Image size (default 1920x1080).", "WxH", "1920x1080");
+    parser.addOptions({imagesOpt, boxesOpt, sizeOpt});
+    parser.addPositionalArgument("dir", "Output directory.");
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) parser.showHelp(2);
+
+    BenchDataset::Spec spec;
+    spec.images = parser.value(imagesOpt).toInt();
+    spec.boxes = parser.value(boxesOpt).toInt();
+    spec.size = BenchDataset::parseSize(parser.value(sizeOpt));
+    if (spec.images <= 0 || spec.boxes < 0 || !spec.size.isValid()) parser.showHelp(2);
+
+    QElapsedTimer t;
+    t.start();
+    QString error;
+    if (!BenchDataset::generate(parser.positionalArguments().at(0), spec, &error)) {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return 1;
+    }
+    std::printf("%d images x %d boxes in %.1f s\n", spec.images, spec.boxes, t.elapsed() / 1000.0);
+    return 0;
+}
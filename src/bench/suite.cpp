@@ -0,0 +1,410 @@
+// Benchmark suite for the interactive and batch hot paths, on a synthetic
+// dataset (see dataset.h). Results go to a JSON file that a later run can
+// be compared against:
+//
+//   imagesuite_bench [--data DIR] [--images N] [--boxes M] [--size WxH]
+//                    [--repeat R] [--filter TEXT] [--json FILE]
+//                    [--label TEXT] [--compare BASE.json]
+//
+// Every case runs once untimed, then R timed times; the median is what
+// gets compared. Caches written by the code under test go to Qt's test
+// locations, never to the user's.
+
+#include "dataset.h"
+
+#include "../annotationcache.h"
+#include "../categoryjournal.h"
+#include "../directoryindex.h"
+#include "../directoryscanner.h"
+#include "../imagedecoder.h"
+#include "../imagesorter.h"
+#include "../imageview.h"
+#include "../transferengine.h"
+#include "../yololabels.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPixmap>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+struct Work {
+    qint64 items = 0;
+    qint64 bytes = 0;
+};
+
+struct Case {
+    QString name;
+    QString unit;                       // what `items` counts
+    std::function<void()> setup;        // untimed, before every run
+    std::function<Work()> run;
+};
+
+struct Result {
+    QString name;
+    QString unit;
+    Work work;
+    QVector<double> runsMs;
+
+    double medianMs() const
+    {
+        QVector<double> v = runsMs;
+        std::sort(v.begin(), v.end());
+        return v.isEmpty() ? 0 : v.size() % 2 ? v.at(v.size() / 2) : (v.at(v.size() / 2 - 1) + v.at(v.size() / 2)) / 2;
+    }
+};
+
+Result measure(const Case &c, int repeat)
+{
+    Result r;
+    r.name = c.name;
+    r.unit = c.unit;
+    for (int i = 0; i <= repeat; ++i) {
+        if (c.setup) c.setup();
+        QElapsedTimer t;
+        t.start();
+        r.work = c.run();
+        const double ms = t.nsecsElapsed() / 1e6;
+        if (i > 0) r.runsMs << ms;   // the first run warms caches
+    }
+    return r;
+}
+
+void removeDirContents(const QString &path)
+{
+    QDir(path).removeRecursively();
+    QDir().mkpath(path);
+}
+
+QStringList imagePaths(const QString &dir, int count)
+{
+    QStringList out;
+    for (int i = 0; i < count; ++i) out << QDir(dir).filePath(BenchDataset::imageName(i));
+    return out;
+}
+
+Work transfer(const QVector<TransferEngine::Item> &items, TransferEngine::Mode mode)
+{
+    TransferEngine engine;
+    QEventLoop loop;
+    QObject::connect(&engine, &TransferEngine::finished, &loop, &QEventLoop::quit);
+    engine.start(items, mode);
+    if (engine.isRunning()) loop.exec();
+    return {engine.filesDone(), engine.bytesDone()};
+}
+
+QJsonObject toJson(const Result &r)
+{
+    QJsonObject o;
+    o["name"] = r.name;
+    o["unit"] = r.unit;
+    o["items"] = double(r.work.items);
+    o["bytes"] = double(r.work.bytes);
+    QJsonArray runs;
+    for (double ms : r.runsMs) runs.append(ms);
+    o["runs_ms"] = runs;
+    const double median = r.medianMs();
+    o["median_ms"] = median;
+    o["min_ms"] = r.runsMs.isEmpty() ? 0 : *std::min_element(r.runsMs.begin(), r.runsMs.end());
+    if (median > 0) {
+        o["items_per_s"] = r.work.items / (median / 1000.0);
+        if (r.work.bytes > 0) o["mb_per_s"] = r.work.bytes / (1024.0 * 1024.0) / (median / 1000.0);
+    }
+    return o;
+}
+
+QHash<QString, double> loadBaseline(const QString &path)
+{
+    QHash<QString, double> medians;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot read %s\n", qPrintable(path));
+        return medians;
+    }
+    const QJsonArray results = QJsonDocument::fromJson(f.readAll()).object().value("results").toArray();
+    for (const QJsonValue &v : results) {
+        const QJsonObject o = v.toObject();
+        medians.insert(o.value("name").toString(), o.value("median_ms").toDouble());
+    }
+    return medians;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Overlay painting needs a QApplication, but never a display.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks scanning, label parsing, decoding, overlay painting, "
+                                     "list I/O and bulk transfers.");
+    parser.addHelpOption();
+    const QCommandLineOption dataOpt("data", "Dataset directory (generated if missing or different).", "dir");
+    const QCommandLineOption imagesOpt("images", "Images in the dataset (default 500).", "N", "500");
+    const QCommandLineOption boxesOpt("boxes", "Boxes per image (default 20).", "M", "20");
+    const QCommandLineOption sizeOpt("size", "Image size (default 1920x1080).", "WxH", "1920x1080");
+    const QCommandLineOption repeatOpt("repeat", "Timed runs per case (default 5).", "R", "5");
+    const QCommandLineOption filterOpt("filter", "Only cases whose name contains TEXT.", "TEXT");
+    const QCommandLineOption jsonOpt("json", "Write the results to FILE.", "FILE");
+    const QCommandLineOption labelOpt("label", "Free text stored with the results (e.g. a commit).", "TEXT");
+    const QCommandLineOption compareOpt("compare", "Print the change against an earlier --json file.", "FILE");
+    parser.addOptions({dataOpt, imagesOpt, boxesOpt, sizeOpt, repeatOpt, filterOpt, jsonOpt, labelOpt, compareOpt});
+    parser.process(app);
+
+    BenchDataset::Spec spec;
+    spec.images = parser.value(imagesOpt).toInt();
+    spec.boxes = parser.value(boxesOpt).toInt();
+    spec.size = BenchDataset::parseSize(parser.value(sizeOpt));
+    const int repeat = std::max(1, parser.value(repeatOpt).toInt());
+    if (spec.images <= 0 || spec.boxes < 0 || !spec.size.isValid()) parser.showHelp(2);
+
+    QTemporaryDir scratch;
+    const QString dataDir = parser.isSet(dataOpt) ? parser.value(dataOpt) : scratch.filePath("dataset");
+    if (!BenchDataset::matches(dataDir, spec)) {
+        std::fprintf(stderr, "generating %d images x %d boxes in %s...\n", spec.images, spec.boxes, qPrintable(dataDir));
+        QString error;
+        if (!BenchDataset::generate(dataDir, spec, &error)) {
+            std::fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+    }
+
+    const QStringList images = imagePaths(dataDir, spec.images);
+    const int decodeCount = std::min(spec.images, 50);
+    const QSize display(1280, 720);   // a typical image label
+    QVector<Case> cases;
+
+    // Directory scanning: listing plus metadata with and without the index.
+    auto scan = [&](bool waitForIndex) {
+        DirectoryScanner scanner;
+        QEventLoop loop;
+        int found = 0;
+        QObject::connect(&scanner, &DirectoryScanner::finished, &loop, [&](const QStringList &names) {
+            found = names.size();
+            if (!waitForIndex) loop.quit();
+        });
+        QObject::connect(&scanner, &DirectoryScanner::indexReady, &loop, [&]() {
+            if (waitForIndex) loop.quit();
+        });
+        scanner.start(dataDir, false);
+        loop.exec();
+        return Work{found, 0};
+    };
+    cases.push_back({"scan.cold", "images",
+                     [&]() { QFile::remove(DirectoryIndex::indexFilePath(dataDir)); },
+                     [&]() { return scan(true); }});
+    cases.push_back({"scan.indexed", "images", nullptr, [&]() { return scan(false); }});
+
+    // Label parsing, as loadYOLOAnnotations() does it.
+    cases.push_back({"labels.parse", "files", nullptr, [&]() {
+        QByteArray buffer;
+        QVector<YoloLabel> labels;
+        Work w;
+        for (const QString &img : images) {
+            if (YoloLabels::readFile(YoloLabels::labelPathFor(img), buffer, labels)) {
+                ++w.items;
+                w.bytes += buffer.size();
+            }
+        }
+        return w;
+    }});
+    AnnotationCache annotations;
+    cases.push_back({"labels.cached", "files", nullptr, [&]() {
+        Work w;
+        for (const QString &img : images) w.items += annotations.labelsFor(img).isEmpty() ? 0 : 1;
+        return w;
+    }});
+
+    // Ordering a listing, as resortImages() does it (keys from the index).
+    DirectoryIndex sortIndex;
+    QStringList sortNames;
+    QThreadPool sortPool;
+    auto loadSortInput = [&]() {
+        if (!sortIndex.load(dataDir)) sortIndex = DirectoryIndex();
+        sortNames = sortIndex.isEmpty() ? QDir(dataDir).entryList(DirectoryScanner::imageNameFilters(), QDir::Files)
+                                        : sortIndex.names();
+    };
+    auto sortBy = [&](ImageOrder::Key key) {
+        ImageOrder order;
+        order.key = key;
+        const QStringList sorted = ImageSorter::sort(dataDir, sortNames, order, sortIndex, LabelIndex(), &sortPool);
+        return Work{sorted.size(), 0};
+    };
+    cases.push_back({"sort.natural", "images", loadSortInput, [&]() { return sortBy(ImageOrder::Natural); }});
+    cases.push_back({"sort.mtime", "images", loadSortInput, [&]() { return sortBy(ImageOrder::Modified); }});
+
+    // Display decode + smooth scale to the label, as updateImage() does it.
+    cases.push_back({"decode.display", "images", nullptr, [&]() {
+        Work w;
+        for (int i = 0; i < decodeCount; ++i) {
+            const QImage img = ImageDecoder::decode(images.at(i), display);
+            const QImage scaled = img.scaled(display, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            w.items += scaled.isNull() ? 0 : 1;
+            w.bytes += QFileInfo(images.at(i)).size();
+        }
+        return w;
+    }});
+    cases.push_back({"decode.full", "images", nullptr, [&]() {
+        Work w;
+        for (int i = 0; i < decodeCount; ++i) {
+            w.items += ImageDecoder::decode(images.at(i), QSize()).isNull() ? 0 : 1;
+            w.bytes += QFileInfo(images.at(i)).size();
+        }
+        return w;
+    }});
+
+    // Overlay painting: ImageView with the boxes of the first image shown.
+    ImageView view;
+    view.setAlignment(Qt::AlignCenter);
+    view.resize(display);
+    view.setPixmap(QPixmap::fromImage(ImageDecoder::decode(images.at(0), display)
+                                          .scaled(display, Qt::KeepAspectRatio, Qt::SmoothTransformation)));
+    view.setAnnotations(annotations.labelsFor(images.at(0)));
+    view.setClassNameProvider([](int id) { return QString("class%1").arg(id); });
+    view.setOverlayVisible(true);
+    QImage frame(display, QImage::Format_ARGB32_Premultiplied);
+    const int frames = 200;
+    cases.push_back({"overlay.paint", "frames", nullptr, [&]() {
+        for (int i = 0; i < frames; ++i) view.render(&frame);
+        return Work{frames, 0};
+    }});
+
+    // Dense detector output: 5k boxes, most of them low confidence.
+    QVector<YoloLabel> dense;
+    QRandomGenerator rng(7);
+    for (int i = 0; i < 5000; ++i) {
+        YoloLabel l;
+        l.classId = rng.bounded(80);
+        l.width = float(0.01 + rng.generateDouble() * 0.1);
+        l.height = float(0.01 + rng.generateDouble() * 0.1);
+        l.xCenter = float(l.width / 2 + rng.generateDouble() * (1 - l.width));
+        l.yCenter = float(l.height / 2 + rng.generateDouble() * (1 - l.height));
+        l.confidence = float(std::pow(rng.generateDouble(), 3));
+        l.hasConfidence = true;
+        dense << l;
+    }
+    cases.push_back({"overlay.dense5k", "frames",
+                     [&]() { view.setAnnotations(dense); view.setMinConfidence(0.0f); },
+                     [&]() {
+                         for (int i = 0; i < frames; ++i) view.render(&frame);
+                         return Work{frames, 0};
+                     }});
+    cases.push_back({"overlay.dense5k.t50", "frames",
+                     [&]() { view.setAnnotations(dense); view.setMinConfidence(0.5f); },
+                     [&]() {
+                         for (int i = 0; i < frames; ++i) view.render(&frame);
+                         return Work{frames, 0};
+                     }});
+
+    // Category list I/O at a realistic size (>= 100k entries).
+    QStringList listPaths;
+    for (int copy = 0; listPaths.size() < 100000; ++copy) {
+        for (const QString &p : images) listPaths << (copy ? p + QString("#%1").arg(copy) : p);
+    }
+    const QString listFile = CategoryJournal::listFilePath(scratch.path(), "bench");
+    cases.push_back({"lists.save", "paths", nullptr, [&]() {
+        CategoryJournal::writeListFile(listFile, listPaths);
+        return Work{listPaths.size(), QFileInfo(listFile).size()};
+    }});
+    cases.push_back({"lists.load", "paths", nullptr, [&]() {
+        QStringList loaded;
+        CategoryJournal::readListFile(listFile, &loaded);
+        return Work{loaded.size(), QFileInfo(listFile).size()};
+    }});
+
+    // Bulk copy into a fresh folder, and a same-filesystem move of a staged copy.
+    const QString copyDest = scratch.filePath("copy");
+    const QString staged = scratch.filePath("staged");
+    const QString moveDest = scratch.filePath("moved");
+    cases.push_back({"transfer.copy", "images",
+                     [&]() { removeDirContents(copyDest); },
+                     [&]() {
+                         QVector<TransferEngine::Item> items;
+                         for (const QString &img : images) items.push_back({img, copyDest, "bench"});
+                         return transfer(items, TransferEngine::Mode::Copy);
+                     }});
+    cases.push_back({"transfer.move", "images",
+                     [&]() {
+                         removeDirContents(moveDest);
+                         removeDirContents(staged);
+                         QVector<TransferEngine::Item> items;
+                         for (const QString &img : images) items.push_back({img, staged, "bench"});
+                         transfer(items, TransferEngine::Mode::Copy);
+                     },
+                     [&]() {
+                         QVector<TransferEngine::Item> items;
+                         for (const QString &img : imagePaths(staged, spec.images)) items.push_back({img, moveDest, "bench"});
+                         return transfer(items, TransferEngine::Mode::Move);
+                     }});
+
+    const QHash<QString, double> baseline = parser.isSet(compareOpt) ? loadBaseline(parser.value(compareOpt))
+                                                                     : QHash<QString, double>();
+    const QString filter = parser.value(filterOpt);
+
+    QJsonArray results;
+    std::printf("%-20s %10s %10s %14s %10s\n", "case", "median ms", "min ms", "items/s", "vs base");
+    for (const Case &c : cases) {
+        if (!filter.isEmpty() && !c.name.contains(filter)) continue;
+
+        const Result r = measure(c, repeat);
+        const QJsonObject o = toJson(r);
+        results.append(o);
+
+        QString delta = "-";
+        if (baseline.value(r.name) > 0)
+            delta = QString("%1%2%").arg(r.medianMs() >= baseline.value(r.name) ? "+" : "")
+                        .arg((r.medianMs() / baseline.value(r.name) - 1) * 100, 0, 'f', 1);
+        std::printf("%-20s %10.2f %10.2f %14.0f %10s\n", qPrintable(r.name), r.medianMs(),
+                    o.value("min_ms").toDouble(), o.value("items_per_s").toDouble(), qPrintable(delta));
+        std::fflush(stdout);
+    }
+
+    if (parser.isSet(jsonOpt)) {
+        QJsonObject dataset;
+        dataset["images"] = spec.images;
+        dataset["boxes"] = spec.boxes;
+        dataset["width"] = spec.size.width();
+        dataset["height"] = spec.size.height();
+
+        QJsonObject root;
+        root["label"] = parser.value(labelOpt);
+        root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        root["qt"] = QString::fromLatin1(qVersion());
+        root["threads"] = QThread::idealThreadCount();
+        root["repeat"] = repeat;
+        root["dataset"] = dataset;
+        root["results"] = results;
+
+        QSaveFile out(parser.value(jsonOpt));
+        if (!out.open(QIODevice::WriteOnly) || out.write(QJsonDocument(root).toJson()) < 0 || !out.commit()) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(parser.value(jsonOpt)));
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Microbenchmark: YOLO label parsing, previous QRegularExpression-based
+// implementation vs. YoloLabels::parse().
+//
+//   yololabels_bench [lines-per-file] [files]
+
+#include "../yololabels.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <cstdio>
+
+namespace {
+
+QByteArray makeLabelFile(int lines, QRandomGenerator &rng)
+{
+    QByteArray out;
+    out.reserve(lines * 48);
+    for (int i = 0; i < lines; ++i) {
+        out += QByteArray::number(rng.bounded(80)) + ' '
+             + QByteArray::number(rng.generateDouble(), 'f', 6) + ' '
+             + QByteArray::number(rng.generateDouble(), 'f', 6) + ' '
+             + QByteArray::number(rng.generateDouble() * 0.2, 'f', 6) + ' '
+             + QByteArray::number(rng.generateDouble() * 0.2, 'f', 6) + ' '
+             + QByteArray::number(rng.generateDouble(), 'f', 4) + '\n';
+    }
+    return out;
+}
+
+// The parser loadYOLOAnnotations() used before YoloLabels existed.
+int parseLegacy(QByteArray &data, QVector<YoloLabel> &out)
+{
+    out.clear();
+    QTextStream in(&data, QIODevice::ReadOnly);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        const QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        if (parts.size() < 5) continue;
+
+        bool ok0=false, ok1=false, ok2=false, ok3=false, ok4=false, ok5=true;
+        YoloLabel l;
+        l.classId = parts[0].toInt(&ok0);
+        l.xCenter = float(parts[1].toDouble(&ok1));
+        l.yCenter = float(parts[2].toDouble(&ok2));
+        l.width = float(parts[3].toDouble(&ok3));
+        l.height = float(parts[4].toDouble(&ok4));
+        if (parts.size() >= 6) l.confidence = parts[5].toFloat(&ok5);
+        if (!(ok0 && ok1 && ok2 && ok3 && ok4 && ok5)) continue;
+        out.push_back(l);
+    }
+    return out.size();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int lines = args.size() > 1 ? args.at(1).toInt() : 2000;
+    const int files = args.size() > 2 ? args.at(2).toInt() : 200;
+
+    QRandomGenerator rng(42);
+    QVector<QByteArray> data;
+    data.reserve(files);
+    for (int i = 0; i < files; ++i) data.push_back(makeLabelFile(lines, rng));
+
+    QVector<YoloLabel> out;
+    out.reserve(lines);
+    qint64 checkLegacy = 0, checkFast = 0;
+
+    QElapsedTimer t;
+    t.start();
+    for (QByteArray &d : data) checkLegacy += parseLegacy(d, out);
+    const double legacyS = t.nsecsElapsed() / 1e9;
+
+    t.restart();
+    for (const QByteArray &d : data) checkFast += YoloLabels::parse(d.constData(), d.constData() + d.size(), out);
+    const double fastS = t.nsecsElapsed() / 1e9;
+
+    const double total = double(lines) * files;
+    std::printf("lines parsed : %.0f (legacy %lld, fast %lld)\n", total, checkLegacy, checkFast);
+    std::printf("legacy       : %12.0f lines/s\n", total / legacyS);
+    std::printf("YoloLabels   : %12.0f lines/s\n", total / fastS);
+    std::printf("speedup      : %12.1fx\n", legacyS / fastS);
+    return checkLegacy == checkFast ? 0 : 1;
+}
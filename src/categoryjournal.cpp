@@ -0,0 +1,407 @@
+#include "categoryjournal.h"
+#include "categorystore.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+const int kFlushDelayMs = 250;
+const int kAutoCompactRecords = 20000;
+
+QByteArray escapeField(const QString &s)
+{
+    QByteArray out;
+    const QByteArray utf8 = s.toUtf8();
+    out.reserve(utf8.size());
+    for (char c : utf8) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '\t': out += "\\t"; break;
+        case '\n': out += "\\n"; break;
+        default:   out += c;
+        }
+    }
+    return out;
+}
+
+QString unescapeField(const char *b, const char *e)
+{
+    QByteArray out;
+    out.reserve(int(e - b));
+    for (const char *p = b; p < e; ++p) {
+        if (*p == '\\' && p + 1 < e) {
+            ++p;
+            out += (*p == 't') ? '\t' : (*p == 'n') ? '\n' : *p;
+        } else {
+            out += *p;
+        }
+    }
+    return QString::fromUtf8(out);
+}
+
+QByteArray record(char op, const QString &category, const QString *path = nullptr)
+{
+    QByteArray r;
+    r += op;
+    r += '\t';
+    r += escapeField(category);
+    if (path) {
+        r += '\t';
+        r += escapeField(*path);
+    }
+    r += '\n';
+    return r;
+}
+
+void syncToDisk(QFile &f)
+{
+    f.flush();
+#ifdef Q_OS_UNIX
+    ::fsync(f.handle());
+#endif
+}
+}
+
+CategoryJournal::CategoryJournal(CategoryStore *store, const QString &dirPath, QObject *parent)
+    : QObject(parent)
+    , store(store)
+    , dirPath(dirPath)
+    , lock(QDir(dirPath).filePath("tags.lock"))
+{
+    QDir().mkpath(QDir(dirPath).filePath("snapshots"));
+
+    // Held for the life of the process; a dead holder's lock is reclaimed.
+    lock.setStaleLockTime(0);
+    owner = lock.tryLock(0);
+    journal.setFileName(QDir(dirPath).filePath("tags.journal"));
+
+    pool.setMaxThreadCount(1);
+
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(kFlushDelayMs);
+    connect(flushTimer, &QTimer::timeout, this, &CategoryJournal::flush);
+
+    // Every change to the store, journaled or not (e.g. pruning), makes the
+    // category's snapshot and list file stale.
+    auto markDirty = [this](const QString &category) {
+        if (trackChanges) dirty.insert(category);
+    };
+    connect(store, &CategoryStore::categoryAdded, this, markDirty);
+    connect(store, &CategoryStore::inserted, this, markDirty);
+    connect(store, &CategoryStore::removed, this, markDirty);
+    connect(store, &CategoryStore::reset, this, markDirty);
+}
+
+CategoryJournal::~CategoryJournal()
+{
+    flush();
+    pool.waitForDone();
+}
+
+QString CategoryJournal::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("tags");
+}
+
+QString CategoryJournal::listFilePath(const QString &listsDir, const QString &category)
+{
+    return QDir(listsDir).filePath(QString("%1_list.txt").arg(category));
+}
+
+QString CategoryJournal::categoryOfListFile(const QString &listPath)
+{
+    static const QLatin1String suffix("_list.txt");
+    const QString name = QFileInfo(listPath).fileName();
+    return name.endsWith(suffix) ? name.left(name.size() - suffix.size()) : QString();
+}
+
+bool CategoryJournal::readListFile(const QString &listPath, QStringList *paths)
+{
+    paths->clear();
+    QFile f(listPath);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    const QByteArray data = f.readAll();
+    for (const QByteArray &line : data.split('\n')) {
+        const QString p = QString::fromUtf8(line).trimmed();
+        if (!p.isEmpty()) paths->push_back(p);
+    }
+    return true;
+}
+
+bool CategoryJournal::writeListFile(const QString &listPath, const QStringList &paths)
+{
+    QSaveFile list(listPath);
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+    QByteArray out;
+    for (const QString &p : paths) {
+        out += p.toUtf8();
+        out += '\n';
+    }
+    list.write(out);
+    return list.commit();
+}
+
+QString CategoryJournal::snapshotFileName(const QString &category)
+{
+    const QByteArray id = QCryptographicHash::hash(category.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString::fromLatin1(id) + ".snap";
+}
+
+// ------------------------------------------------------------
+// Replay
+// ------------------------------------------------------------
+QString CategoryJournal::lockHolder() const
+{
+    qint64 pid = 0;
+    QString host, app;
+    if (!lock.getLockInfo(&pid, &host, &app)) return "another process";
+    return QString("%1 (pid %2) on %3").arg(app.isEmpty() ? QString("a process") : app).arg(pid).arg(host);
+}
+
+int CategoryJournal::replay()
+{
+    const QDir snapDir(QDir(dirPath).filePath("snapshots"));
+
+    // Snapshots are already compacted; only journal records leave work.
+    trackChanges = false;
+    for (const QString &name : snapDir.entryList({"*.snap"}, QDir::Files))
+        replayFile(snapDir.filePath(name));
+    trackChanges = true;
+
+    recordsSinceCompaction += replayFile(QDir(dirPath).filePath("tags.journal.compacting"));
+    recordsSinceCompaction += replayFile(journal.fileName());
+    return store->totalCount();
+}
+
+int CategoryJournal::replayFile(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(owner ? QIODevice::ReadWrite : QIODevice::ReadOnly)) return 0;
+    const QByteArray data = f.readAll();
+
+    // A crash can leave a torn last record; drop it so later appends start
+    // on a fresh line. (Without the lock it may be the owner's write.)
+    const int end = data.lastIndexOf('\n') + 1;
+    if (owner && end < data.size()) f.resize(end);
+    f.close();
+
+    // Consecutive adds/removes on one category are applied as one batch.
+    QString batchCat;
+    char batchOp = 0;
+    QStringList batch;
+    auto applyBatch = [&]() {
+        if (batch.isEmpty()) return;
+        if (batchOp == '+') store->add(batchCat, batch);
+        else                store->remove(batchCat, QSet<QString>(batch.begin(), batch.end()));
+        batch.clear();
+    };
+
+    int records = 0;
+    const char *p = data.constData();
+    const char *const stop = p + end;
+    while (p < stop) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', size_t(stop - p)));
+        const char *f1 = static_cast<const char *>(std::memchr(p, '\t', size_t(eol - p)));
+        if (!f1 || f1 != p + 1) { p = eol + 1; continue; }
+
+        const char op = *p;
+        const char *f2 = static_cast<const char *>(std::memchr(f1 + 1, '\t', size_t(eol - f1 - 1)));
+        const QString cat = unescapeField(f1 + 1, f2 ? f2 : eol);
+
+        if ((op == '+' || op == '-') && f2) {
+            if (op != batchOp || cat != batchCat) {
+                applyBatch();
+                batchOp = op;
+                batchCat = cat;
+            }
+            batch << unescapeField(f2 + 1, eol);
+            ++records;
+        } else if (op == 'N' || op == 'C') {
+            applyBatch();
+            if (op == 'N') store->addCategory(cat);
+            else           store->clear(cat);
+            ++records;
+        }
+        p = eol + 1;
+    }
+    applyBatch();
+    return records;
+}
+
+// ------------------------------------------------------------
+// Recording
+// ------------------------------------------------------------
+void CategoryJournal::recordCategory(const QString &category)
+{
+    append(record('N', category));
+}
+
+void CategoryJournal::recordAdd(const QString &category, const QString &path)
+{
+    append(record('+', category, &path));
+}
+
+void CategoryJournal::recordRemove(const QString &category, const QStringList &paths)
+{
+    QByteArray r;
+    for (const QString &p : paths) r += record('-', category, &p);
+    if (!r.isEmpty()) append(r, paths.size());
+}
+
+void CategoryJournal::recordClear(const QString &category)
+{
+    append(record('C', category));
+}
+
+void CategoryJournal::append(const QByteArray &records, int count)
+{
+    if (!owner) return;
+    buffer += records;
+    recordsSinceCompaction += count;
+    if (!flushTimer->isActive()) flushTimer->start();
+
+    if (recordsSinceCompaction >= kAutoCompactRecords && !compacting) compact();
+}
+
+void CategoryJournal::flush()
+{
+    flushTimer->stop();
+    if (buffer.isEmpty()) return;
+
+    if (!journal.isOpen() && !journal.open(QIODevice::WriteOnly | QIODevice::Append)) return;
+    journal.write(buffer);
+    syncToDisk(journal);
+    buffer.clear();
+}
+
+// ------------------------------------------------------------
+// Compaction
+// ------------------------------------------------------------
+void CategoryJournal::setListsDirectory(const QString &dir)
+{
+    if (dir == listsDir) return;
+    listsDir = dir;
+
+    // A new target needs every list written once.
+    for (const QString &c : store->categories()) dirty.insert(c);
+}
+
+bool CategoryJournal::rotate()
+{
+    flush();
+    journal.close();
+
+    const QString segment = QDir(dirPath).filePath("tags.journal.compacting");
+    if (!QFile::exists(journal.fileName())) return true;
+    if (!QFile::exists(segment)) return QFile::rename(journal.fileName(), segment);
+
+    // A previous compaction failed and left its segment; extend it.
+    QFile seg(segment);
+    QFile cur(journal.fileName());
+    if (!seg.open(QIODevice::WriteOnly | QIODevice::Append) || !cur.open(QIODevice::ReadOnly))
+        return false;
+    seg.write(cur.readAll());
+    syncToDisk(seg);
+    cur.close();
+    return cur.remove();
+}
+
+void CategoryJournal::compact(bool full)
+{
+    if (!owner) {
+        emit compacted(false);
+        return;
+    }
+    if (compacting) {
+        compactAgain = true;
+        compactAgainFull = compactAgainFull || full;
+        return;
+    }
+
+    if (full) {
+        for (const QString &c : store->categories()) dirty.insert(c);
+    }
+    if (dirty.isEmpty() && recordsSinceCompaction == 0) {
+        emit compacted(true);
+        return;
+    }
+    if (!rotate()) {
+        emit compacted(false);
+        return;
+    }
+
+    Job job;
+    job.snapshotDir = QDir(dirPath).filePath("snapshots");
+    job.listsDir = listsDir;
+    job.segmentPath = QDir(dirPath).filePath("tags.journal.compacting");
+    job.categories = dirty.values();
+    job.categories.sort();
+    for (const QString &c : qAsConst(job.categories)) job.paths << store->paths(c);   // shared, no copy
+
+    dirty.clear();
+    recordsSinceCompaction = 0;
+    compacting = true;
+
+    pool.start([this, job]() {
+        const bool ok = runJob(job);
+        const QStringList cats = job.categories;
+        QMetaObject::invokeMethod(this, [this, cats, ok]() {
+            onCompacted(cats, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+bool CategoryJournal::runJob(const Job &job)
+{
+    bool ok = true;
+    for (int i = 0; i < job.categories.size(); ++i) {
+        const QString &cat = job.categories.at(i);
+        const QStringList &paths = job.paths.at(i);
+
+        QSaveFile snap(QDir(job.snapshotDir).filePath(snapshotFileName(cat)));
+        if (snap.open(QIODevice::WriteOnly)) {
+            QByteArray out = record('N', cat);
+            for (const QString &p : paths) out += record('+', cat, &p);
+            snap.write(out);
+            ok = snap.commit() && ok;
+        } else {
+            ok = false;
+        }
+
+        if (job.listsDir.isEmpty()) continue;
+        ok = writeListFile(listFilePath(job.listsDir, cat), paths) && ok;
+    }
+
+    // The segment is only redundant once every snapshot made it to disk.
+    if (ok) QFile::remove(job.segmentPath);
+    return ok;
+}
+
+void CategoryJournal::onCompacted(const QStringList &categories, bool ok)
+{
+    compacting = false;
+    if (!ok) {
+        for (const QString &c : categories) dirty.insert(c);
+    }
+    emit compacted(ok);
+
+    if (compactAgain) {
+        const bool full = compactAgainFull;
+        compactAgain = false;
+        compactAgainFull = false;
+        compact(full);
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef CATEGORYJOURNAL_H
+#define CATEGORYJOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QLockFile>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+class CategoryStore;
+class QTimer;
+
+// Durable, incremental persistence for a CategoryStore.
+//
+// Tag edits are appended to a journal and flushed in groups (one write +
+// fsync per burst of keystrokes). Compaction runs on a worker thread: it
+// rewrites a per-category snapshot and the user-facing <category>_list.txt
+// for the categories that changed only, each through QSaveFile, and then
+// drops the journal segment it covered.
+//
+// On disk (under `dirPath`):
+//   snapshots/<sha1>.snap   one per category, same record format
+//   tags.journal            records since the last compaction started
+//   tags.journal.compacting segment being folded into the snapshots
+//
+// Records are "N\tcat", "+\tcat\tpath", "-\tcat\tpath" and "C\tcat", one
+// per line. Replaying a record twice converges to the same membership, so
+// a crash at any point in a compaction loses nothing.
+//
+// One process owns a journal directory at a time (tags.lock): the
+// application or the --headless CLI. Without the lock the journal is
+// read-only; replay() works, edits are not persisted.
+class CategoryJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    CategoryJournal(CategoryStore *store, const QString &dirPath, QObject *parent = nullptr);
+    ~CategoryJournal() override;
+
+    static QString defaultDirectory();
+
+    bool isOwner() const { return owner; }
+    QString lockHolder() const;   // who holds tags.lock, for messages
+    static QString listFilePath(const QString &listsDir, const QString &category);
+
+    // <category>_list.txt: one UTF-8 path per line. The category of a list
+    // file is its name without the "_list.txt" suffix (empty if it has none).
+    static QString categoryOfListFile(const QString &listPath);
+    static bool readListFile(const QString &listPath, QStringList *paths);
+    static bool writeListFile(const QString &listPath, const QStringList &paths);
+
+    // Loads snapshots and journal segments into the store. Returns the
+    // number of tagged paths restored.
+    int replay();
+
+    void recordCategory(const QString &category);
+    void recordAdd(const QString &category, const QString &path);
+    void recordRemove(const QString &category, const QStringList &paths);
+    void recordClear(const QString &category);
+
+    // Writes buffered records now.
+    void flush();
+
+    // Directory the <category>_list.txt files are written to (may be empty).
+    void setListsDirectory(const QString &dir);
+    QString listsDirectory() const { return listsDir; }
+
+    // Folds the journal into the snapshots in the background. `full`
+    // rewrites every category instead of only the changed ones.
+    void compact(bool full = false);
+    bool isCompacting() const { return compacting; }
+
+signals:
+    void compacted(bool ok);
+
+private:
+    struct Job {
+        QString snapshotDir;
+        QString listsDir;
+        QString segmentPath;
+        QStringList categories;
+        QList<QStringList> paths;
+    };
+
+    void append(const QByteArray &records, int count = 1);
+    bool rotate();
+    int replayFile(const QString &path);
+    static bool runJob(const Job &job);
+    void onCompacted(const QStringList &categories, bool ok);
+
+    static QString snapshotFileName(const QString &category);
+
+    CategoryStore *store = nullptr;
+    QString dirPath;
+    QString listsDir;
+
+    QLockFile lock;
+    bool owner = false;
+
+    QFile journal;
+    QByteArray buffer;
+    QTimer *flushTimer = nullptr;
+    int recordsSinceCompaction = 0;
+
+    QSet<QString> dirty;
+    bool trackChanges = true;
+
+    QThreadPool pool;
+    bool compacting = false;
+    bool compactAgain = false;
+    bool compactAgainFull = false;
+};
+
+#endif // CATEGORYJOURNAL_H
@@ -0,0 +1,44 @@
+#include "categorylistmodel.h"
+#include "categorystore.h"
+
+CategoryListModel::CategoryListModel(CategoryStore *store, const QString &category, QObject *parent)
+    : QAbstractListModel(parent)
+    , store(store)
+    , cat(category)
+{
+    connect(store, &CategoryStore::aboutToInsert, this, [this](const QString &c, int first, int last) {
+        if (c == cat) beginInsertRows(QModelIndex(), first, last);
+    });
+    connect(store, &CategoryStore::inserted, this, [this](const QString &c) {
+        if (c == cat) endInsertRows();
+    });
+    connect(store, &CategoryStore::aboutToRemove, this, [this](const QString &c, int first, int last) {
+        if (c == cat) beginRemoveRows(QModelIndex(), first, last);
+    });
+    connect(store, &CategoryStore::removed, this, [this](const QString &c) {
+        if (c == cat) endRemoveRows();
+    });
+    connect(store, &CategoryStore::aboutToReset, this, [this](const QString &c) {
+        if (c == cat) beginResetModel();
+    });
+    connect(store, &CategoryStore::reset, this, [this](const QString &c) {
+        if (c == cat) endResetModel();
+    });
+}
+
+QString CategoryListModel::pathAt(int row) const
+{
+    return store->pathAt(cat, row);
+}
+
+int CategoryListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : store->count(cat);
+}
+
+QVariant CategoryListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return {};
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole) return pathAt(index.row());
+    return {};
+}
@@ -0,0 +1,29 @@
+#ifndef CATEGORYLISTMODEL_H
+#define CATEGORYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+
+class CategoryStore;
+
+// Read-only list model over one category of a CategoryStore. Holds no copy
+// of the paths; row changes are forwarded from the store's signals.
+class CategoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    CategoryListModel(CategoryStore *store, const QString &category, QObject *parent = nullptr);
+
+    QString category() const { return cat; }
+    QString pathAt(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    CategoryStore *store = nullptr;
+    QString cat;
+};
+
+#endif // CATEGORYLISTMODEL_H
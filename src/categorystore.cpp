@@ -0,0 +1,167 @@
+#include "categorystore.h"
+
+#include <algorithm>
+
+CategoryStore::CategoryStore(QObject *parent)
+    : QObject(parent)
+{
+}
+
+CategoryStore::Category &CategoryStore::categoryFor(const QString &category)
+{
+    auto it = cats.find(category);
+    if (it == cats.end()) {
+        it = cats.insert(category, Category());
+        emit categoryAdded(category);
+    }
+    return it.value();
+}
+
+void CategoryStore::addCategory(const QString &category)
+{
+    categoryFor(category);
+}
+
+const QStringList &CategoryStore::paths(const QString &category) const
+{
+    static const QStringList empty;
+    const auto it = cats.constFind(category);
+    return it == cats.constEnd() ? empty : it->order;
+}
+
+QString CategoryStore::pathAt(const QString &category, int row) const
+{
+    const QStringList &list = paths(category);
+    return (row >= 0 && row < list.size()) ? list.at(row) : QString();
+}
+
+int CategoryStore::count(const QString &category) const
+{
+    return paths(category).size();
+}
+
+bool CategoryStore::contains(const QString &category, const QString &path) const
+{
+    const auto it = cats.constFind(category);
+    return it != cats.constEnd() && it->row.contains(path);
+}
+
+int CategoryStore::rowOf(const QString &category, const QString &path) const
+{
+    const auto it = cats.constFind(category);
+    return it == cats.constEnd() ? -1 : it->row.value(path, -1);
+}
+
+bool CategoryStore::add(const QString &category, const QString &path)
+{
+    return add(category, QStringList{path}) == 1;
+}
+
+int CategoryStore::add(const QString &category, const QStringList &paths)
+{
+    Category &c = categoryFor(category);
+
+    QStringList fresh;
+    QSet<QString> seen;
+    for (const QString &p : paths) {
+        if (c.row.contains(p) || seen.contains(p)) continue;
+        seen.insert(p);
+        fresh << p;
+    }
+    if (fresh.isEmpty()) return 0;
+
+    const int first = c.order.size();
+    emit aboutToInsert(category, first, first + fresh.size() - 1);
+    for (const QString &p : qAsConst(fresh)) {
+        c.row.insert(p, c.order.size());
+        c.order.append(p);
+        pathCategories[p].insert(category);
+    }
+    emit inserted(category);
+    return fresh.size();
+}
+
+void CategoryStore::reindex(Category &c)
+{
+    c.row.clear();
+    c.row.reserve(c.order.size());
+    for (int i = 0; i < c.order.size(); ++i) c.row.insert(c.order.at(i), i);
+}
+
+void CategoryStore::forgetMembership(const QString &path, const QString &category)
+{
+    auto it = pathCategories.find(path);
+    if (it == pathCategories.end()) return;
+    it->remove(category);
+    if (it->isEmpty()) pathCategories.erase(it);
+}
+
+int CategoryStore::remove(const QString &category, const QSet<QString> &paths)
+{
+    auto it = cats.find(category);
+    if (it == cats.end() || paths.isEmpty()) return 0;
+
+    Category &c = it.value();
+    QVector<int> rows;
+    for (const QString &p : paths) {
+        const int row = c.row.value(p, -1);
+        if (row >= 0) rows << row;
+    }
+    if (rows.isEmpty()) return 0;
+    std::sort(rows.begin(), rows.end());
+
+    // One contiguous block maps onto a row removal; anything scattered is
+    // compacted in a single pass and announced as a reset of the category.
+    const bool contiguous = rows.last() - rows.first() + 1 == rows.size();
+    if (contiguous) emit aboutToRemove(category, rows.first(), rows.last());
+    else            emit aboutToReset(category);
+
+    QStringList kept;
+    kept.reserve(c.order.size() - rows.size());
+    for (const QString &p : qAsConst(c.order)) {
+        if (paths.contains(p)) forgetMembership(p, category);
+        else                   kept << p;
+    }
+    c.order = kept;
+    reindex(c);
+
+    if (contiguous) emit removed(category);
+    else            emit reset(category);
+    return rows.size();
+}
+
+void CategoryStore::clear(const QString &category)
+{
+    auto it = cats.find(category);
+    if (it == cats.end() || it->order.isEmpty()) return;
+
+    emit aboutToReset(category);
+    for (const QString &p : qAsConst(it->order)) forgetMembership(p, category);
+    it->order.clear();
+    it->row.clear();
+    emit reset(category);
+}
+
+int CategoryStore::prune(const std::function<bool(const QString &)> &missing)
+{
+    // Test each distinct path once, then remove per affected category.
+    QMap<QString, QSet<QString>> goneByCategory;
+    for (auto it = pathCategories.constBegin(); it != pathCategories.constEnd(); ++it) {
+        if (!missing(it.key())) continue;
+        for (const QString &cat : it.value()) goneByCategory[cat].insert(it.key());
+    }
+
+    int removedCount = 0;
+    for (auto it = goneByCategory.constBegin(); it != goneByCategory.constEnd(); ++it)
+        removedCount += remove(it.key(), it.value());
+    return removedCount;
+}
+
+QStringList CategoryStore::categoriesOf(const QString &path) const
+{
+    const auto it = pathCategories.constFind(path);
+    if (it == pathCategories.constEnd()) return {};
+    QStringList out = it->values();
+    out.sort();
+    return out;
+}
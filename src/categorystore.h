@@ -0,0 +1,79 @@
+#ifndef CATEGORYSTORE_H
+#define CATEGORYSTORE_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+// Tagged image paths per category. Keeps insertion order for display and
+// saving, with a hash index per category (membership / row lookup in O(1))
+// and a reverse map from path to the categories it is tagged in.
+//
+// Removing a set of paths is one linear pass over the affected categories,
+// never one scan per removed path.
+//
+// Changes are announced per category in model terms (row ranges / reset)
+// so list models over a category can forward them without copying paths.
+class CategoryStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CategoryStore(QObject *parent = nullptr);
+
+    bool hasCategory(const QString &category) const { return cats.contains(category); }
+    void addCategory(const QString &category);
+    QStringList categories() const { return cats.keys(); }
+
+    // Paths of `category` in insertion order (empty list if unknown).
+    const QStringList &paths(const QString &category) const;
+    QString pathAt(const QString &category, int row) const;
+    int count(const QString &category) const;
+    int totalCount() const { return pathCategories.size(); }
+
+    bool contains(const QString &category, const QString &path) const;
+    int rowOf(const QString &category, const QString &path) const;   // -1 if absent
+
+    // Appends `path`; false if it is already in the category.
+    bool add(const QString &category, const QString &path);
+    // Appends the paths not yet in the category as one batch.
+    int add(const QString &category, const QStringList &paths);
+
+    int remove(const QString &category, const QSet<QString> &paths);
+    void clear(const QString &category);
+
+    // Drops every path for which `missing` returns true from all categories.
+    // Each distinct path is tested once, however many categories hold it.
+    int prune(const std::function<bool(const QString &)> &missing);
+
+    QStringList categoriesOf(const QString &path) const;
+
+signals:
+    void categoryAdded(const QString &category);
+    void aboutToInsert(const QString &category, int first, int last);
+    void inserted(const QString &category);
+    void aboutToRemove(const QString &category, int first, int last);
+    void removed(const QString &category);
+    void aboutToReset(const QString &category);
+    void reset(const QString &category);
+
+private:
+    struct Category {
+        QStringList order;
+        QHash<QString, int> row;
+    };
+
+    Category &categoryFor(const QString &category);
+    static void reindex(Category &c);
+    void forgetMembership(const QString &path, const QString &category);
+
+    QMap<QString, Category> cats;
+    QHash<QString, QSet<QString>> pathCategories;   // path -> categories
+};
+
+#endif // CATEGORYSTORE_H
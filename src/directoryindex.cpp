@@ -0,0 +1,117 @@
+#include "directoryindex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace {
+const quint32 kMagic = 0x41494458;   // "AIDX"
+const quint16 kVersion = 2;
+// Serialized size of an entry with an empty name; bounds the stored count.
+const qint64 kMinEntryBytes = 4 + 8 + 8 + 4 + 4 + 1 + 8;
+}
+
+QString DirectoryIndex::indexFilePath(const QString &dirPath)
+{
+    const QString canonical = QFileInfo(dirPath).canonicalFilePath().isEmpty()
+                                  ? QDir(dirPath).absolutePath()
+                                  : QFileInfo(dirPath).canonicalFilePath();
+    const QByteArray id = QCryptographicHash::hash(canonical.toUtf8(), QCryptographicHash::Sha1).toHex();
+
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return QDir(base).filePath(QString("dirindex/%1.idx").arg(QString::fromLatin1(id)));
+}
+
+qint64 DirectoryIndex::directoryMtime(const QString &dirPath)
+{
+    const QFileInfo fi(dirPath);
+    return fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+bool DirectoryIndex::load(const QString &path)
+{
+    entries.clear();
+    dirPath = path;
+    dirMtime = 0;
+
+    QFile f(indexFilePath(path));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString storedPath;
+    quint32 count = 0;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) return false;
+
+    in >> storedPath >> dirMtime >> count;
+    if (in.status() != QDataStream::Ok) return false;
+    // A hash collision or a copied cache directory must not load another
+    // folder's entries; a corrupt count must not drive the allocation.
+    if (storedPath != QDir(path).absolutePath()
+        || qint64(count) > (f.size() - f.pos()) / kMinEntryBytes) {
+        dirMtime = 0;
+        return false;
+    }
+
+    entries.resize(int(count));
+    for (Entry &e : entries) {
+        quint8 label = 0;
+        in >> e.name >> e.size >> e.mtime >> e.width >> e.height >> label >> e.captureTime;
+        e.hasLabel = label != 0;
+    }
+    if (in.status() != QDataStream::Ok) {
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DirectoryIndex::save() const
+{
+    const QString file = indexFilePath(dirPath);
+    QDir().mkpath(QFileInfo(file).absolutePath());
+
+    QSaveFile f(file);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << kMagic << kVersion << QDir(dirPath).absolutePath() << dirMtime << quint32(entries.size());
+    for (const Entry &e : entries)
+        out << e.name << e.size << e.mtime << e.width << e.height << quint8(e.hasLabel ? 1 : 0)
+            << e.captureTime;
+
+    return f.commit();
+}
+
+bool DirectoryIndex::isFresh() const
+{
+    return dirMtime != 0 && dirMtime == directoryMtime(dirPath);
+}
+
+QStringList DirectoryIndex::names() const
+{
+    QStringList out;
+    out.reserve(entries.size());
+    for (const Entry &e : entries) out << e.name;
+    return out;
+}
+
+const DirectoryIndex::Entry *DirectoryIndex::find(const QString &name) const
+{
+    const auto it = std::lower_bound(entries.cbegin(), entries.cend(), name,
+                                     [](const Entry &e, const QString &n) { return e.name < n; });
+    if (it == entries.cend() || it->name != name) return nullptr;
+    return &*it;
+}
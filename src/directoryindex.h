@@ -0,0 +1,42 @@
+#ifndef DIRECTORYINDEX_H
+#define DIRECTORYINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// On-disk listing of an image directory, stored under the user cache
+// directory ($XDG_CACHE_HOME). It is trusted as long as the directory's own
+// mtime is unchanged, which covers files being created, removed or renamed.
+class DirectoryIndex
+{
+public:
+    struct Entry {
+        QString name;            // file name relative to the directory
+        qint64 size = 0;
+        qint64 mtime = 0;        // ms since epoch
+        qint32 width = 0;        // 0 if the header could not be read
+        qint32 height = 0;
+        bool hasLabel = false;   // YOLO <basename>.txt next to the image
+        qint64 captureTime = 0;  // EXIF, ms since epoch; 0 if the file has none
+    };
+
+    static QString indexFilePath(const QString &dirPath);
+    static qint64 directoryMtime(const QString &dirPath);
+
+    bool load(const QString &dirPath);
+    bool save() const;
+    bool isFresh() const;
+
+    bool isEmpty() const { return entries.isEmpty(); }
+    QStringList names() const;
+
+    // Entries are kept sorted by name; lookup is a binary search.
+    const Entry *find(const QString &name) const;
+
+    QString dirPath;
+    qint64 dirMtime = 0;
+    QVector<Entry> entries;
+};
+
+#endif // DIRECTORYINDEX_H
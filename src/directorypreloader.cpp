@@ -0,0 +1,103 @@
+#include "directorypreloader.h"
+#include "directoryscanner.h"
+#include "imagecache.h"
+#include "imagedecoder.h"
+#include "profiler.h"
+
+#include <QDir>
+
+#include <algorithm>
+
+DirectoryPreloader::DirectoryPreloader(ImageCache *cache, QObject *parent)
+    : QObject(parent)
+    , cache(cache)
+    , scanner(new DirectoryScanner(this))
+    , generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    // Background work only; the current directory's prefetcher comes first.
+    pool.setMaxThreadCount(1);
+    connect(scanner, &DirectoryScanner::finished, this, &DirectoryPreloader::onListed);
+}
+
+DirectoryPreloader::~DirectoryPreloader()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    pool.waitForDone();
+}
+
+void DirectoryPreloader::preload(const QString &path, const QSize &size, int images)
+{
+    const QString abs = QDir(path).absolutePath();
+    if (abs == dirPath && size == target) return;   // already on it
+
+    cancel();
+    dirPath = abs;
+    target = size;
+    imageCount = std::max(0, images);
+    scanner->start(dirPath, false);
+}
+
+void DirectoryPreloader::cancel()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    scanner->cancel();
+    dirPath.clear();
+    listed = false;
+    names.clear();
+    pendingDecodes = 0;
+}
+
+bool DirectoryPreloader::take(const QString &path, QStringList *out)
+{
+    const bool ok = listed && QDir(path).absolutePath() == dirPath;
+    if (ok) *out = names;
+
+    // Decodes still in flight land in the cache regardless.
+    if (ok || QDir(path).absolutePath() != dirPath) {
+        scanner->cancel();
+        dirPath.clear();
+        listed = false;
+        names.clear();
+    }
+    return ok;
+}
+
+void DirectoryPreloader::onListed(const QStringList &sortedNames)
+{
+    if (dirPath.isEmpty()) return;
+    listed = true;
+    names = sortedNames;
+
+    const QDir dir(dirPath);
+    const quint64 gen = generation->load();
+    auto genRef = generation;
+    const QSize size = target;
+    pendingDecodes = 0;
+    for (int i = 0; i < std::min(imageCount, int(names.size())); ++i) {
+        const QString path = dir.filePath(names.at(i));
+        const QString key = ImageCache::keyFor(path);
+        if (cache->covers(key, size)) continue;
+
+        ++pendingDecodes;
+        pool.start([this, genRef, gen, path, key, size]() {
+            if (genRef->load() != gen) return;
+
+            PROFILE_SCOPE("preload.decode");
+            QSize sourceSize;
+            const QImage img = ImageDecoder::decode(path, size, &sourceSize);
+            QMetaObject::invokeMethod(this, [this, genRef, gen, key, img, sourceSize]() {
+                if (genRef->load() != gen) return;
+                onDecoded(key, img, sourceSize);
+            }, Qt::QueuedConnection);
+        });
+    }
+    if (pendingDecodes == 0) emit preloaded(dirPath, 0);
+}
+
+void DirectoryPreloader::onDecoded(const QString &key, const QImage &img, const QSize &sourceSize)
+{
+    if (!img.isNull() && !cache->covers(key, img.size())) cache->insertImage(key, img, sourceSize);
+    if (--pendingDecodes == 0 && !dirPath.isEmpty()) emit preloaded(dirPath, std::min(imageCount, int(names.size())));
+}
@@ -0,0 +1,59 @@
+#ifndef DIRECTORYPRELOADER_H
+#define DIRECTORYPRELOADER_H
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+class DirectoryScanner;
+class ImageCache;
+
+// Warms up the directory the user is likely to open next: lists it with a
+// scanner of its own (which also refreshes its DirectoryIndex) and decodes
+// its first images into the shared ImageCache. Opening the directory then
+// takes the listing and finds the first image already decoded.
+//
+// Only one directory is preloaded at a time; asking for another one, or
+// cancel(), drops the previous one.
+class DirectoryPreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DirectoryPreloader(ImageCache *cache, QObject *parent = nullptr);
+    ~DirectoryPreloader() override;
+
+    // Decodes the first `images` images to fit `target`.
+    void preload(const QString &dirPath, const QSize &target, int images = 3);
+    void cancel();
+
+    // The sorted listing of `dirPath` if it has been preloaded. Hands it
+    // over: the preloader is idle afterwards.
+    bool take(const QString &dirPath, QStringList *names);
+
+signals:
+    void preloaded(const QString &dirPath, int images);
+
+private:
+    void onListed(const QStringList &names);
+    void onDecoded(const QString &key, const QImage &img, const QSize &sourceSize);
+
+    ImageCache *cache = nullptr;
+    DirectoryScanner *scanner = nullptr;
+    QThreadPool pool;
+    std::shared_ptr<std::atomic<quint64>> generation;
+
+    QString dirPath;           // absolute, empty when idle
+    QSize target;
+    int imageCount = 0;
+    bool listed = false;
+    QStringList names;
+    int pendingDecodes = 0;
+};
+
+#endif // DIRECTORYPRELOADER_H
@@ -0,0 +1,171 @@
+#include "directoryscanner.h"
+#include "imagedecoder.h"
+#include "profiler.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSet>
+
+#include <algorithm>
+
+DirectoryScanner::DirectoryScanner(QObject *parent)
+    : QObject(parent)
+    , generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    pool.setMaxThreadCount(1);
+}
+
+DirectoryScanner::~DirectoryScanner()
+{
+    cancel();
+    pool.waitForDone();
+}
+
+QStringList DirectoryScanner::imageNameFilters()
+{
+    return { "*.png", "*.jpg", "*.jpeg", "*.JPG", "*.JPEG", "*.PNG" };
+}
+
+bool DirectoryScanner::isImageName(const QString &name)
+{
+    // Same set as imageNameFilters(), which QDir matches case-insensitively
+    // (".Jpg" and the like included).
+    static const char *const suffixes[] = { ".png", ".jpg", ".jpeg" };
+    for (const char *s : suffixes) {
+        if (name.endsWith(QLatin1String(s), Qt::CaseInsensitive)) return true;
+    }
+    return false;
+}
+
+void DirectoryScanner::start(const QString &dirPath, bool streamBatches)
+{
+    const quint64 gen = generation->fetch_add(1) + 1;
+    pool.clear();
+    running = true;
+
+    auto genRef = generation;
+    pool.start([this, genRef, gen, dirPath, streamBatches]() {
+        auto deliver = [&](const QStringList &names) {
+            QMetaObject::invokeMethod(this, [this, genRef, gen, names]() {
+                if (genRef->load() != gen) return;
+                running = false;
+                emit finished(names);
+            }, Qt::QueuedConnection);
+        };
+        auto deliverIndex = [&](const DirectoryIndex &index) {
+            QMetaObject::invokeMethod(this, [this, genRef, gen, index]() {
+                if (genRef->load() == gen) emit indexReady(index);
+            }, Qt::QueuedConnection);
+        };
+
+        // Fast path: the cached index is still valid for this directory.
+        DirectoryIndex index;
+        bool fresh = false;
+        {
+            PROFILE_SCOPE("scan.indexLoad");
+            fresh = index.load(dirPath) && index.isFresh();
+        }
+        if (fresh) {
+            deliver(index.names());
+            deliverIndex(index);
+            return;
+        }
+
+        // Read the directory mtime before listing, so changes made during
+        // the scan invalidate the index we are about to write.
+        index.entries.clear();
+        index.dirPath = dirPath;
+        index.dirMtime = DirectoryIndex::directoryMtime(dirPath);
+
+        QStringList all;
+        QStringList batch;
+        QSet<QString> labelBases;
+
+        // Small first batch so the first image shows up quickly, larger
+        // ones afterwards to keep the number of queued events low.
+        int batchLimit = 64;
+        QElapsedTimer sinceFlush;
+        sinceFlush.start();
+
+        auto flush = [&]() {
+            if (batch.isEmpty()) return;
+            std::sort(batch.begin(), batch.end());
+            QMetaObject::invokeMethod(this, [this, genRef, gen, batch]() {
+                if (genRef->load() == gen) emit batchReady(batch);
+            }, Qt::QueuedConnection);
+            batch.clear();
+            batchLimit = 1024;
+            sinceFlush.restart();
+        };
+
+        // One readdir pass collects both the images and their label files.
+        {
+            PROFILE_SCOPE("scan.readdir");
+            QDirIterator it(dirPath, QDir::Files);
+            while (it.hasNext()) {
+                if (genRef->load() != gen) return;
+
+                it.next();
+                const QString name = it.fileName();
+                if (name.endsWith(QLatin1String(".txt"))) {
+                    labelBases.insert(name.left(name.size() - 4));
+                    continue;
+                }
+                if (!isImageName(name)) continue;
+
+                all << name;
+                if (streamBatches) {
+                    batch << name;
+                    if (batch.size() >= batchLimit || sinceFlush.elapsed() > 50) flush();
+                }
+            }
+            if (streamBatches) flush();
+        }
+
+        // Same ordering as QDir::Name (plain QString comparison).
+        std::sort(all.begin(), all.end());
+        deliver(all);
+
+        // Metadata pass for the index; the listing is already in the GUI.
+        PROFILE_SCOPE("scan.metadata");
+        const QDir dir(dirPath);
+        index.entries.reserve(all.size());
+        for (const QString &name : all) {
+            if (genRef->load() != gen) return;
+
+            const QString path = dir.filePath(name);
+            const QFileInfo fi(path);
+
+            DirectoryIndex::Entry e;
+            e.name = name;
+            e.size = fi.size();
+            e.mtime = fi.lastModified().toMSecsSinceEpoch();
+            // One open for both the EXIF date and the header dimensions.
+            QFile file(path);
+            QSize dims;
+            if (file.open(QIODevice::ReadOnly)) {
+                e.captureTime = ImageDecoder::captureTime(&file);
+                dims = QImageReader(&file).size();
+            }
+            e.width = dims.width() > 0 ? dims.width() : 0;
+            e.height = dims.height() > 0 ? dims.height() : 0;
+            e.hasLabel = labelBases.contains(fi.completeBaseName());
+            index.entries.push_back(e);
+        }
+
+        index.save();
+        deliverIndex(index);
+    });
+}
+
+void DirectoryScanner::cancel()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    running = false;
+}
@@ -0,0 +1,49 @@
+#ifndef DIRECTORYSCANNER_H
+#define DIRECTORYSCANNER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "directoryindex.h"
+
+#include <atomic>
+#include <memory>
+
+// Lists the images of a directory on a background thread. Names are streamed
+// in batches (readdir order) while the scan runs, then the complete list is
+// delivered sorted like QDir::Name.
+//
+// A fresh DirectoryIndex short-circuits the scan; otherwise the index is
+// rebuilt (sizes, mtimes, dimensions, label presence) after the listing has
+// been delivered and saved for the next visit.
+class DirectoryScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DirectoryScanner(QObject *parent = nullptr);
+    ~DirectoryScanner() override;
+
+    static QStringList imageNameFilters();
+    static bool isImageName(const QString &name);
+
+    // Starts a scan of `dirPath`, cancelling any scan still running. With
+    // `streamBatches` off only finished() is emitted (used for rescans where
+    // the current list stays valid until the new one is complete).
+    void start(const QString &dirPath, bool streamBatches);
+    void cancel();
+    bool isRunning() const { return running; }
+
+signals:
+    void batchReady(const QStringList &names);
+    void finished(const QStringList &sortedNames);
+    void indexReady(const DirectoryIndex &index);
+
+private:
+    QThreadPool pool;
+    std::shared_ptr<std::atomic<quint64>> generation;
+    bool running = false;
+};
+
+#endif // DIRECTORYSCANNER_H
@@ -0,0 +1,158 @@
+#include "directorywatcher.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+const uint32_t kMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                       | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+}
+
+DirectoryWatcher::DirectoryWatcher(QObject *parent)
+    : QObject(parent)
+{
+#ifdef Q_OS_LINUX
+    fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &DirectoryWatcher::readEvents);
+        return;
+    }
+#endif
+    fallback = new QFileSystemWatcher(this);
+    connect(fallback, &QFileSystemWatcher::directoryChanged, this, [this](const QString &dir) {
+        if (QDir(dir).exists()) emit rescanNeeded(dir);
+        else emit directoryRemoved(dir);
+    });
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+#ifdef Q_OS_LINUX
+    if (fd >= 0) {
+        notifier->setEnabled(false);
+        ::close(fd);
+    }
+#endif
+}
+
+bool DirectoryWatcher::watch(const QString &dirPath)
+{
+    const QString dir = QDir(dirPath).absolutePath();
+    if (watchOfDir.contains(dir)) return true;
+
+#ifdef Q_OS_LINUX
+    if (fd >= 0) {
+        const int wd = ::inotify_add_watch(fd, QFile::encodeName(dir).constData(), kMask);
+        if (wd < 0) return false;
+        dirOfWatch.insert(wd, dir);
+        watchOfDir.insert(dir, wd);
+        return true;
+    }
+#endif
+    if (!fallback->addPath(dir)) return false;
+    watchOfDir.insert(dir, -1);
+    return true;
+}
+
+void DirectoryWatcher::unwatch(const QString &dirPath)
+{
+    const QString dir = QDir(dirPath).absolutePath();
+    const auto it = watchOfDir.constFind(dir);
+    if (it == watchOfDir.constEnd()) return;
+
+#ifdef Q_OS_LINUX
+    if (fd >= 0) {
+        ::inotify_rm_watch(fd, it.value());
+        dirOfWatch.remove(it.value());
+    }
+#endif
+    if (fallback) fallback->removePath(dir);
+    watchOfDir.erase(it);
+}
+
+bool DirectoryWatcher::isWatching(const QString &dirPath) const
+{
+    return watchOfDir.contains(QDir(dirPath).absolutePath());
+}
+
+void DirectoryWatcher::processPending()
+{
+    if (fd >= 0) readEvents();
+}
+
+void DirectoryWatcher::readEvents()
+{
+#ifdef Q_OS_LINUX
+    Changes changes;
+    QHash<uint32_t, QString> movedFrom;   // cookie -> path, paired with IN_MOVED_TO
+    QStringList gone;
+    bool overflow = false;
+
+    alignas(struct inotify_event) char buf[64 * 1024];
+    for (;;) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) break;   // EAGAIN: drained
+
+        for (ssize_t off = 0; off < n;) {
+            const auto *ev = reinterpret_cast<const struct inotify_event *>(buf + off);
+            off += ssize_t(sizeof(struct inotify_event)) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+            const QString dir = dirOfWatch.value(ev->wd);
+            if (dir.isEmpty()) continue;
+
+            if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                gone << dir;
+                continue;
+            }
+            if (ev->mask & IN_IGNORED) {
+                watchOfDir.remove(dir);
+                dirOfWatch.remove(ev->wd);
+                continue;
+            }
+            if ((ev->mask & IN_ISDIR) || ev->len == 0) continue;
+
+            const QString path = dir + QLatin1Char('/') + QFile::decodeName(ev->name);
+            if (ev->mask & IN_MOVED_FROM) {
+                movedFrom.insert(ev->cookie, path);
+            } else if (ev->mask & IN_MOVED_TO) {
+                const QString from = movedFrom.take(ev->cookie);
+                if (from.isEmpty()) changes.added << path;
+                else changes.renamed.push_back({from, path});
+            } else if (ev->mask & IN_DELETE) {
+                changes.removed << path;
+            } else if (ev->mask & IN_CLOSE_WRITE) {
+                changes.added << path;
+            } else if (ev->mask & IN_CREATE) {
+                // A hard link (no-replace rename) is complete on arrival; a
+                // new file being written is reported on IN_CLOSE_WRITE.
+                struct stat st;
+                if (::lstat(QFile::encodeName(path).constData(), &st) == 0 && st.st_nlink > 1)
+                    changes.added << path;
+            }
+        }
+    }
+    // Moved out of every watched directory.
+    for (const QString &from : qAsConst(movedFrom)) changes.removed << from;
+
+    if (!changes.added.isEmpty() || !changes.removed.isEmpty() || !changes.renamed.isEmpty())
+        emit changed(changes);
+    for (const QString &dir : qAsConst(gone)) emit directoryRemoved(dir);
+    if (overflow) emit rescanNeeded(QString());
+#endif
+}
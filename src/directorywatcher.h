@@ -0,0 +1,65 @@
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QFileSystemWatcher;
+class QSocketNotifier;
+
+// Per-file change notifications for a set of directories, read from one
+// inotify descriptor through a QSocketNotifier on the GUI thread. Events
+// read together are delivered as one Changes batch:
+//
+//   added    file finished writing, moved in, or hard-linked in
+//   removed  file deleted or moved out
+//   renamed  moved between two watched names (from, to)
+//
+// A file is only "added" once its writer closed it, so a capture that is
+// still writing never shows up half-written. When the kernel queue
+// overflows, or on platforms without inotify (QFileSystemWatcher only
+// says "something changed"), rescanNeeded() asks for a full re-list.
+class DirectoryWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Changes {
+        QStringList added;                          // absolute paths
+        QStringList removed;
+        QVector<QPair<QString, QString>> renamed;
+    };
+
+    explicit DirectoryWatcher(QObject *parent = nullptr);
+    ~DirectoryWatcher() override;
+
+    // True if changes are reported per file (inotify is available).
+    bool isLive() const { return fd >= 0; }
+
+    bool watch(const QString &dirPath);
+    void unwatch(const QString &dirPath);
+    bool isWatching(const QString &dirPath) const;
+
+    // Delivers the events the kernel has queued so far, right now.
+    void processPending();
+
+signals:
+    void changed(const DirectoryWatcher::Changes &changes);
+    void rescanNeeded(const QString &dirPath);   // empty: every directory
+    void directoryRemoved(const QString &dirPath);
+
+private:
+    void readEvents();
+
+    int fd = -1;
+    QSocketNotifier *notifier = nullptr;
+    QFileSystemWatcher *fallback = nullptr;
+    QHash<int, QString> dirOfWatch;
+    QHash<QString, int> watchOfDir;
+};
+
+#endif // DIRECTORYWATCHER_H
@@ -0,0 +1,161 @@
+#include "eventlog.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QUuid>
+
+EventLog::EventLog(QObject *parent)
+    : QObject(parent)
+{
+    flushTimer = new QTimer(this);
+    flushTimer->setInterval(1000);
+    connect(flushTimer, &QTimer::timeout, this, &EventLog::flush);
+}
+
+EventLog::~EventLog()
+{
+    close();
+}
+
+QString EventLog::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("events");
+}
+
+bool EventLog::open(const QString &path, qint64 maxFileBytes, int maxFiles)
+{
+    close();
+
+    dirPath = path;
+    maxBytes = maxFileBytes;
+    keepFiles = maxFiles;
+    if (!QDir().mkpath(dirPath)) return false;
+
+    // Full UUID: eventsummary merges sessions by this id across all files.
+    session = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    sessionWallStart = QDateTime::currentMSecsSinceEpoch();
+    clock.start();
+    fileSeq = 0;
+
+    if (!openNextFile()) return false;
+    flushTimer->start();
+    return true;
+}
+
+void EventLog::close()
+{
+    if (!file.isOpen()) return;
+
+    record("session_end", {});
+    flush();
+    flushTimer->stop();
+    file.close();
+}
+
+bool EventLog::openNextFile()
+{
+    file.close();
+
+    const QString stamp = QDateTime::fromMSecsSinceEpoch(sessionWallStart).toString("yyyyMMdd_HHmmss");
+    file.setFileName(QDir(dirPath).filePath(QString("events_%1_%2_%3.jsonl")
+                                                .arg(stamp, session)
+                                                .arg(fileSeq++, 3, 10, QChar('0'))));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+
+    QJsonObject header;
+    header["wall"] = double(sessionWallStart);
+    header["app"] = QCoreApplication::applicationVersion();
+    header["part"] = fileSeq - 1;
+    record("session_start", header);
+
+    pruneOldFiles();
+    return true;
+}
+
+void EventLog::pruneOldFiles()
+{
+    if (keepFiles <= 0) return;
+
+    // Names start with the session timestamp, so name order is age order.
+    QDir dir(dirPath);
+    const QStringList files = dir.entryList({"events_*.jsonl"}, QDir::Files, QDir::Name);
+    for (int i = 0; i < files.size() - keepFiles; ++i) dir.remove(files.at(i));
+}
+
+void EventLog::record(const char *type, QJsonObject fields)
+{
+    if (!file.isOpen()) return;
+
+    fields["s"] = session;
+    fields["t"] = double(clock.elapsed());
+    fields["type"] = QString::fromLatin1(type);
+    buffer += QJsonDocument(fields).toJson(QJsonDocument::Compact);
+    buffer += '\n';
+}
+
+void EventLog::flush()
+{
+    if (buffer.isEmpty() || !file.isOpen()) return;
+
+    // Roll over before writing so a new file always starts with its header.
+    if (file.size() > 0 && file.size() + buffer.size() > maxBytes) {
+        QByteArray pending;
+        pending.swap(buffer);
+        if (!openNextFile()) return;
+        buffer += pending;
+    }
+
+    file.write(buffer);
+    file.flush();
+    buffer.clear();
+}
+
+void EventLog::loadDir(const QString &dir, int images, qint64 scanMs)
+{
+    QJsonObject o;
+    o["dir"] = dir;
+    o["images"] = images;
+    o["scan_ms"] = double(scanMs);
+    record("load_dir", o);
+}
+
+void EventLog::navigate(int index, int count)
+{
+    QJsonObject o;
+    o["index"] = index;
+    o["count"] = count;
+    record("navigate", o);
+}
+
+void EventLog::tag(const QString &category, const QString &path, qint64 dwellMs)
+{
+    QJsonObject o;
+    o["category"] = category;
+    o["path"] = path;
+    o["dwell_ms"] = double(dwellMs);
+    record("tag", o);
+}
+
+void EventLog::remove(const QString &category, int count)
+{
+    QJsonObject o;
+    o["category"] = category;
+    o["count"] = count;
+    record("remove", o);
+}
+
+void EventLog::bulkOp(const QString &op, int files, int failed, qint64 bytes, qint64 ms, bool cancelled)
+{
+    QJsonObject o;
+    o["op"] = op;
+    o["files"] = files;
+    o["failed"] = failed;
+    o["bytes"] = double(bytes);
+    o["ms"] = double(ms);
+    o["cancelled"] = cancelled;
+    record("bulk_op", o);
+}
@@ -0,0 +1,65 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+// Structured session events for throughput analysis, one compact JSON
+// object per line:
+//
+//   {"s":"<session>","t":<ms since session start>,"type":"tag",...}
+//
+// "t" comes from a monotonic clock; the wall-clock start time is only in
+// the "session_start" record. Lines are buffered and written once a second.
+// Files roll over at `maxFileBytes`; each new file repeats the session
+// header so every file can be read on its own. tools/eventsummary turns a
+// directory of these files into the throughput report.
+class EventLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EventLog(QObject *parent = nullptr);
+    ~EventLog() override;
+
+    static QString defaultDirectory();
+
+    // `maxFiles` > 0 deletes the oldest files beyond that count.
+    bool open(const QString &dirPath, qint64 maxFileBytes = qint64(16) * 1024 * 1024, int maxFiles = 0);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    void loadDir(const QString &dir, int images, qint64 scanMs);
+    void navigate(int index, int count);
+    void tag(const QString &category, const QString &path, qint64 dwellMs);
+    void remove(const QString &category, int count);
+    void bulkOp(const QString &op, int files, int failed, qint64 bytes, qint64 ms, bool cancelled);
+
+    void flush();
+
+private:
+    void record(const char *type, QJsonObject fields);
+    bool openNextFile();
+    void pruneOldFiles();
+
+    QString dirPath;
+    qint64 maxBytes = 0;
+    int keepFiles = 0;
+
+    QString session;
+    qint64 sessionWallStart = 0;
+    QElapsedTimer clock;
+    int fileSeq = 0;
+
+    QFile file;
+    QByteArray buffer;
+    QTimer *flushTimer = nullptr;
+};
+
+#endif // EVENTLOG_H
@@ -0,0 +1,92 @@
+#include "filmstripmodel.h"
+#include "thumbnailcache.h"
+
+#include <QColor>
+#include <QFileInfo>
+
+FilmstripModel::FilmstripModel(ThumbnailCache *thumbnails, QObject *parent)
+    : QAbstractListModel(parent)
+    , thumbnails(thumbnails)
+{
+    placeholder = QPixmap(ThumbnailCache::kSize, ThumbnailCache::kSize * 3 / 4);
+    placeholder.fill(QColor("#d0d0d0"));
+
+    connect(thumbnails, &ThumbnailCache::thumbnailReady, this, &FilmstripModel::onThumbnailReady);
+}
+
+void FilmstripModel::setImages(const QDir &d, const QStringList &n)
+{
+    beginResetModel();
+    dir = d;
+    names = n;
+    waiting.clear();
+    endResetModel();
+    thumbnails->cancelPending();
+}
+
+void FilmstripModel::appendImages(const QStringList &n)
+{
+    if (n.isEmpty()) return;
+    beginInsertRows(QModelIndex(), names.size(), names.size() + n.size() - 1);
+    names += n;
+    endInsertRows();
+}
+
+void FilmstripModel::insertImage(int row, const QString &name)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    names.insert(row, name);
+    endInsertRows();
+}
+
+void FilmstripModel::removeImage(int row)
+{
+    if (row < 0 || row >= names.size()) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    waiting.remove(dir.filePath(names.at(row)));
+    names.removeAt(row);
+    endRemoveRows();
+}
+
+void FilmstripModel::refreshImage(int row)
+{
+    if (row < 0 || row >= names.size()) return;
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { Qt::DecorationRole });
+}
+
+int FilmstripModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : names.size();
+}
+
+QVariant FilmstripModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= names.size()) return QVariant();
+
+    const QString &name = names.at(index.row());
+    if (role == Qt::ToolTipRole) return name;
+    if (role != Qt::DecorationRole) return QVariant();
+
+    const QString path = dir.filePath(name);
+    QPixmap pix;
+    if (thumbnails->request(path, &pix)) return pix;
+
+    waiting.insert(path, index.row());
+    return placeholder;
+}
+
+void FilmstripModel::onThumbnailReady(const QString &path)
+{
+    const auto it = waiting.find(path);
+    if (it == waiting.end()) return;
+
+    const QString name = QFileInfo(path).fileName();
+    int row = it.value();
+    waiting.erase(it);
+    if (names.value(row) != name) row = names.indexOf(name);
+    if (row < 0) return;
+
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { Qt::DecorationRole });
+}
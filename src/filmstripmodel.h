@@ -0,0 +1,44 @@
+#ifndef FILMSTRIPMODEL_H
+#define FILMSTRIPMODEL_H
+
+#include <QAbstractListModel>
+#include <QDir>
+#include <QHash>
+#include <QPixmap>
+#include <QStringList>
+
+class ThumbnailCache;
+
+// List model over the images of the current directory for the filmstrip.
+// Thumbnails are only requested from data(), i.e. for the rows the view
+// actually paints, so very large folders stay cheap.
+class FilmstripModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit FilmstripModel(ThumbnailCache *thumbnails, QObject *parent = nullptr);
+
+    void setImages(const QDir &dir, const QStringList &names);
+    void appendImages(const QStringList &names);
+    void insertImage(int row, const QString &name);
+    void removeImage(int row);
+    void refreshImage(int row);   // thumbnail changed, e.g. file rewritten
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    void onThumbnailReady(const QString &path);
+
+    ThumbnailCache *thumbnails = nullptr;
+    QDir dir;
+    QStringList names;
+    QPixmap placeholder;
+
+    // Thumbnails requested but not yet available, with the row they had
+    // then; rows shift on inserts, so the row is only a hint.
+    mutable QHash<QString, int> waiting;
+};
+
+#endif // FILMSTRIPMODEL_H
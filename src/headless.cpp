@@ -0,0 +1,431 @@
+#include "headless.h"
+#include "categoryjournal.h"
+#include "categorystore.h"
+#include "directoryscanner.h"
+#include "eventlog.h"
+#include "transferengine.h"
+#include "yololabels.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+enum Exit { ExitOk = 0, ExitProblems = 1, ExitUsage = 2 };
+
+volatile std::sig_atomic_t interrupted = 0;
+
+void onInterrupt(int)
+{
+    interrupted = 1;
+}
+
+struct Options {
+    QCommandLineOption lists{"lists", "Use every <category>_list.txt in <dir>.", "dir"};
+    QCommandLineOption journal{"journal", "Use the tags recorded by the application."};
+    QCommandLineOption category{"category", "Only this category (repeatable).", "name"};
+    QCommandLineOption dest{"dest", "Put category C into <dir>/C.", "dir"};
+    QCommandLineOption map{"map", "Put category C into <dir> (repeatable).", "C=dir"};
+    QCommandLineOption report{"report", "Per-file JSON lines report.", "file"};
+    QCommandLineOption updateLists{"update-lists", "After a move, drop moved images from the input list files."};
+    QCommandLineOption names{"names", "Class names (.names); enables class id checks.", "file"};
+    QCommandLineOption recursive{QStringList{"r", "recursive"}, "Validate subdirectories too."};
+    QCommandLineOption requireLabels{"require-labels", "Report images without a label file."};
+    QCommandLineOption jobs{"jobs", "Worker threads for validate (default: all cores).", "n"};
+    QCommandLineOption quiet{QStringList{"q", "quiet"}, "No progress output."};
+};
+
+int usage(const QCommandLineParser &parser, const QString &message)
+{
+    std::fprintf(stderr, "%s\n\n%s", qPrintable(message), qPrintable(parser.helpText()));
+    return ExitUsage;
+}
+
+// ------------------------------------------------------------
+// copy / move / delete
+// ------------------------------------------------------------
+int runTransfer(const QCommandLineParser &parser, const Options &o, const QString &command)
+{
+    const bool quiet = parser.isSet(o.quiet);
+    const QStringList onlyCats = parser.values(o.category);
+    auto wanted = [&](const QString &cat) { return onlyCats.isEmpty() || onlyCats.contains(cat); };
+
+    // Category -> images, from list files and/or the application's journal.
+    QMap<QString, QStringList> byCat;
+    QMap<QString, QString> listFileOf;   // list file -> category, for --update-lists
+
+    QStringList listFiles = parser.positionalArguments().mid(1);
+    if (parser.isSet(o.lists)) {
+        const QDir d(parser.value(o.lists));
+        for (const QString &name : d.entryList({"*_list.txt"}, QDir::Files, QDir::Name))
+            listFiles << d.filePath(name);
+    }
+    for (const QString &file : listFiles) {
+        QString cat = CategoryJournal::categoryOfListFile(file);
+        if (cat.isEmpty()) cat = QFileInfo(file).completeBaseName();
+        if (!wanted(cat)) continue;
+
+        QStringList paths;
+        if (!CategoryJournal::readListFile(file, &paths)) {
+            std::fprintf(stderr, "cannot read %s\n", qPrintable(file));
+            return ExitProblems;
+        }
+        byCat[cat] << paths;
+        listFileOf[file] = cat;
+    }
+
+    CategoryStore store;
+    std::unique_ptr<CategoryJournal> journal;
+    if (parser.isSet(o.journal)) {
+        journal.reset(new CategoryJournal(&store, CategoryJournal::defaultDirectory()));
+        if (!journal->isOwner()) {
+            std::fprintf(stderr, "the tag journal is in use by %s; close it or drop --journal\n",
+                         qPrintable(journal->lockHolder()));
+            return ExitProblems;
+        }
+        journal->replay();
+        for (const QString &cat : store.categories()) {
+            if (wanted(cat)) byCat[cat] << store.paths(cat);
+        }
+    }
+    if (byCat.isEmpty()) return usage(parser, "No lists given (list files, --lists or --journal).");
+
+    // Destinations.
+    QMap<QString, QString> catToDir;
+    for (const QString &m : parser.values(o.map)) {
+        const int eq = m.indexOf('=');
+        if (eq <= 0) return usage(parser, "Bad --map " + m);
+        catToDir[m.left(eq)] = m.mid(eq + 1);
+    }
+    QVector<TransferEngine::Item> items;
+    for (auto it = byCat.constBegin(); it != byCat.constEnd(); ++it) {
+        QString dir = catToDir.value(it.key());
+        if (dir.isEmpty() && parser.isSet(o.dest)) dir = QDir(parser.value(o.dest)).filePath(it.key());
+        if (dir.isEmpty()) return usage(parser, QString("No destination for category '%1'.").arg(it.key()));
+
+        if (!QDir().mkpath(dir)) {
+            std::fprintf(stderr, "cannot create %s\n", qPrintable(dir));
+            return ExitProblems;
+        }
+        for (const QString &src : it.value()) items.push_back({src, dir, it.key()});
+    }
+
+    const bool copy = command == "copy";
+    QString reportPath = parser.value(o.report);
+    if (reportPath.isEmpty()) {
+        const QString reportDir = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("reports");
+        const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+        reportPath = QDir(reportDir).filePath(QString("transfer_%1.jsonl").arg(stamp));
+    }
+
+    TransferEngine engine;
+    engine.setReportPath(reportPath);
+
+    QMap<QString, QStringList> done;
+    int failed = 0;
+    QElapsedTimer sinceProgress;
+    sinceProgress.start();
+
+    QObject::connect(&engine, &TransferEngine::progress, &engine, [&]() {
+        if (interrupted && !engine.wasCancelled()) {
+            std::fprintf(stderr, "\ninterrupted, finishing the files in flight...\n");
+            engine.cancel();
+        }
+        if (quiet || sinceProgress.elapsed() < 1000) return;
+        sinceProgress.restart();
+        const double secs = engine.elapsedMs() / 1000.0;
+        std::fprintf(stderr, "\r%d / %d images, %.1f MB/s   ", engine.filesDone(), engine.filesTotal(),
+                     secs > 0 ? engine.bytesDone() / secs / (1024.0 * 1024.0) : 0.0);
+    });
+    QObject::connect(&engine, &TransferEngine::itemFinished, &engine, [&](const TransferEngine::Result &r) {
+        if (r.ok) {
+            done[r.category] << r.source;
+            if (!r.labelOk) std::fprintf(stderr, "\nlabel failed: %s\n", qPrintable(r.source));
+        } else if (r.error != "cancelled") {
+            ++failed;
+            std::fprintf(stderr, "\nfailed: %s (%s)\n", qPrintable(r.source), qPrintable(r.error));
+        }
+    });
+
+    QEventLoop loop;
+    QObject::connect(&engine, &TransferEngine::finished, &loop, &QEventLoop::quit);
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    engine.start(items, copy ? TransferEngine::Mode::Copy : TransferEngine::Mode::Move);
+    if (engine.isRunning()) loop.exec();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+
+    int moved = 0;
+    for (const QStringList &l : done) moved += l.size();
+    std::fprintf(stderr, "%s%s %d of %d images (%d failed), %.1f MB in %.1f s\nreport: %s\n",
+                 quiet ? "" : "\n", copy ? "copied" : "moved", moved, engine.filesTotal(), failed,
+                 engine.bytesDone() / (1024.0 * 1024.0), engine.elapsedMs() / 1000.0,
+                 qPrintable(engine.lastReportPath()));
+
+    EventLog events;
+    if (events.open(EventLog::defaultDirectory())) {
+        events.bulkOp(command, engine.filesTotal(), failed, engine.bytesDone(),
+                      engine.elapsedMs(), engine.wasCancelled());
+        events.close();
+    }
+
+    // Moved images leave their categories, as in the window.
+    if (!copy && !done.isEmpty()) {
+        if (journal) {
+            for (auto it = done.constBegin(); it != done.constEnd(); ++it) {
+                const QSet<QString> gone(it.value().begin(), it.value().end());
+                store.remove(it.key(), gone);
+                journal->recordRemove(it.key(), it.value());
+            }
+            journal->setListsDirectory(QSettings().value("lists/saveDir").toString());
+
+            QEventLoop compaction;
+            QObject::connect(journal.get(), &CategoryJournal::compacted, &compaction, &QEventLoop::quit);
+            journal->compact(true);
+            if (journal->isCompacting()) compaction.exec();
+        }
+        if (parser.isSet(o.updateLists)) {
+            for (auto it = listFileOf.constBegin(); it != listFileOf.constEnd(); ++it) {
+                const QStringList &gone = done.value(it.value());
+                if (gone.isEmpty()) continue;
+
+                const QSet<QString> goneSet(gone.begin(), gone.end());
+                QStringList paths;
+                CategoryJournal::readListFile(it.key(), &paths);
+                paths.erase(std::remove_if(paths.begin(), paths.end(),
+                                           [&](const QString &p) { return goneSet.contains(p); }),
+                            paths.end());
+                if (!CategoryJournal::writeListFile(it.key(), paths))
+                    std::fprintf(stderr, "cannot update %s\n", qPrintable(it.key()));
+            }
+        }
+    }
+
+    return failed > 0 || engine.wasCancelled() ? ExitProblems : ExitOk;
+}
+
+// ------------------------------------------------------------
+// validate
+// ------------------------------------------------------------
+struct LabelCheck {
+    qint64 images = 0;
+    qint64 labels = 0;
+    qint64 boxes = 0;
+    qint64 missing = 0;
+    QStringList problems;   // "path: what"
+};
+
+int nonBlankLines(const QByteArray &data)
+{
+    int lines = 0;
+    bool blank = true;
+    for (const char c : data) {
+        if (c == '\n') {
+            if (!blank) ++lines;
+            blank = true;
+        } else if (!std::strchr(" \t\r\v\f", c)) {
+            blank = false;
+        }
+    }
+    return blank ? lines : lines + 1;
+}
+
+void checkImages(const QStringList &images, int classCount, bool requireLabels, LabelCheck &out)
+{
+    // Coordinates a little outside [0, 1] are rounding, not bad labels.
+    const float eps = 1e-3f;
+
+    QByteArray buffer;
+    QVector<YoloLabel> labels;
+    for (const QString &image : images) {
+        ++out.images;
+        const QString txt = YoloLabels::labelPathFor(image);
+        if (!YoloLabels::readFile(txt, buffer, labels)) {
+            if (QFileInfo::exists(txt)) {
+                out.problems << txt + ": cannot read";
+            } else {
+                ++out.missing;
+                if (requireLabels) out.problems << image + ": no label file";
+            }
+            continue;
+        }
+        ++out.labels;
+        out.boxes += labels.size();
+
+        QStringList what;
+        const int malformed = nonBlankLines(buffer) - labels.size();
+        if (malformed > 0) what << QString("%1 malformed line(s)").arg(malformed);
+
+        int outside = 0, empty = 0;
+        QSet<int> unknown;
+        for (const YoloLabel &l : labels) {
+            if (l.classId < 0 || (classCount > 0 && l.classId >= classCount)) unknown.insert(l.classId);
+            if (l.width <= 0 || l.height <= 0) {
+                ++empty;
+                continue;
+            }
+            if (l.xCenter - l.width / 2 < -eps || l.xCenter + l.width / 2 > 1 + eps
+                || l.yCenter - l.height / 2 < -eps || l.yCenter + l.height / 2 > 1 + eps)
+                ++outside;
+        }
+        if (empty) what << QString("%1 empty box(es)").arg(empty);
+        if (outside) what << QString("%1 box(es) outside the image").arg(outside);
+        if (!unknown.isEmpty()) {
+            QList<int> ids = unknown.values();
+            std::sort(ids.begin(), ids.end());
+            QStringList s;
+            for (int id : ids) s << QString::number(id);
+            what << "unknown class " + s.join(',');
+        }
+        if (!what.isEmpty()) out.problems << txt + ": " + what.join("; ");
+    }
+}
+
+int runValidate(const QCommandLineParser &parser, const Options &o)
+{
+    const QStringList roots = parser.positionalArguments().mid(1);
+    if (roots.isEmpty()) return usage(parser, "validate needs at least one directory.");
+
+    int classCount = 0;
+    if (parser.isSet(o.names)) {
+        QStringList names;
+        if (!CategoryJournal::readListFile(parser.value(o.names), &names)) {
+            std::fprintf(stderr, "cannot read %s\n", qPrintable(parser.value(o.names)));
+            return ExitProblems;
+        }
+        classCount = names.size();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList dirs;
+    for (const QString &root : roots) {
+        if (!QFileInfo(root).isDir()) return usage(parser, root + " is not a directory.");
+        dirs << root;
+        if (!parser.isSet(o.recursive)) continue;
+        QDirIterator it(root, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) dirs << it.next();
+    }
+
+    QThreadPool pool;
+    if (parser.isSet(o.jobs)) pool.setMaxThreadCount(std::max(1, parser.value(o.jobs).toInt()));
+    else pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    QMutex mutex;
+    LabelCheck total;
+    QStringList orphans;
+    const bool requireLabels = parser.isSet(o.requireLabels);
+
+    auto merge = [&](const LabelCheck &part) {
+        QMutexLocker lock(&mutex);
+        total.images += part.images;
+        total.labels += part.labels;
+        total.boxes += part.boxes;
+        total.missing += part.missing;
+        total.problems << part.problems;
+    };
+
+    // One readdir per directory here; label parsing fans out in chunks.
+    const int kChunk = 256;
+    for (const QString &dirPath : dirs) {
+        const QDir dir(dirPath);
+        QStringList images;
+        QSet<QString> imageBases;
+        QStringList txts;
+        for (const QString &name : dir.entryList(QDir::Files, QDir::Name)) {
+            if (DirectoryScanner::isImageName(name)) {
+                images << dir.filePath(name);
+                imageBases.insert(QFileInfo(name).completeBaseName());
+            } else if (name.endsWith(QLatin1String(".txt"))) {
+                txts << name;
+            }
+        }
+        for (const QString &name : txts) {
+            if (name == QLatin1String("classes.txt")) continue;
+            if (!imageBases.contains(name.left(name.size() - 4))) orphans << dir.filePath(name) + ": no image";
+        }
+
+        for (int i = 0; i < images.size(); i += kChunk) {
+            const QStringList chunk = images.mid(i, kChunk);
+            pool.start([chunk, classCount, requireLabels, &merge]() {
+                LabelCheck part;
+                checkImages(chunk, classCount, requireLabels, part);
+                merge(part);
+            });
+        }
+    }
+    pool.waitForDone();
+
+    QStringList problems = total.problems + orphans;
+    std::sort(problems.begin(), problems.end());
+    for (const QString &p : problems) std::fprintf(stdout, "%s\n", qPrintable(p));
+
+    if (!parser.isSet(o.quiet)) {
+        std::fprintf(stderr, "%lld images in %d directories: %lld labels, %lld boxes, %lld without label, "
+                             "%d orphan label(s), %d problem(s) (%.1f s)\n",
+                     total.images, int(dirs.size()), total.labels, total.boxes, total.missing,
+                     int(orphans.size()), int(problems.size()), timer.elapsed() / 1000.0);
+    }
+    return problems.isEmpty() ? ExitOk : ExitProblems;
+}
+
+} // namespace
+
+namespace Headless {
+
+bool requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+int run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Applies saved category lists and checks YOLO labels without a display.\n\n"
+        "  copy|move [lists...]   transfer the images (and labels) of each list\n"
+        "  delete [lists...]      move them into a trash folder per category, as the window does\n"
+        "  validate <dirs...>     check label syntax, box bounds and class ids\n\n"
+        "Exit status: 0 ok, 1 failures or problems found, 2 usage error.");
+    parser.addHelpOption();
+
+    Options o;
+    const QCommandLineOption headless("headless", "Run without a window.");
+    parser.addOptions({headless, o.lists, o.journal, o.category, o.dest, o.map, o.report, o.updateLists,
+                       o.names, o.recursive, o.requireLabels, o.jobs, o.quiet});
+    parser.addPositionalArgument("command", "copy, move, delete or validate.");
+    parser.addPositionalArgument("inputs", "List files (copy/move/delete) or directories (validate).", "[inputs...]");
+    parser.process(arguments);
+
+    const QString command = parser.positionalArguments().value(0);
+    if (command == "copy" || command == "move" || command == "delete") return runTransfer(parser, o, command);
+    if (command == "validate") return runValidate(parser, o);
+    return usage(parser, command.isEmpty() ? "No command given." : "Unknown command " + command);
+}
+
+} // namespace Headless
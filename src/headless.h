@@ -0,0 +1,21 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <QStringList>
+
+// `AI_ImageSuite --headless <command> ...`: runs list actions and label
+// checks without a display, on the same core library the window uses
+// (TransferEngine, YoloLabels, CategoryJournal).
+//
+//   copy | move | delete   transfer the images of saved category lists
+//   validate               check the YOLO labels below some directories
+//
+// Runs under a QCoreApplication; nothing here touches QtWidgets.
+namespace Headless {
+
+bool requested(int argc, char *argv[]);
+int run(const QStringList &arguments);
+
+} // namespace Headless
+
+#endif // HEADLESS_H
@@ -0,0 +1,106 @@
+#include "imagecache.h"
+#include "imagedecoder.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <limits>
+
+ImageCache::ImageCache(qint64 budgetBytes)
+{
+    setBudget(budgetBytes);
+}
+
+QString ImageCache::keyFor(const QString &path)
+{
+    const QFileInfo fi(path);
+    return fi.absoluteFilePath() + QLatin1Char('|') + QString::number(fi.lastModified().toMSecsSinceEpoch());
+}
+
+void ImageCache::setBudget(qint64 bytes)
+{
+    const qint64 kib = std::clamp<qint64>(bytes / 1024, 1, std::numeric_limits<int>::max());
+    cache.setMaxCost(int(kib));
+}
+
+qint64 ImageCache::budget() const
+{
+    return qint64(cache.maxCost()) * 1024;
+}
+
+qint64 ImageCache::used() const
+{
+    return qint64(cache.totalCost()) * 1024;
+}
+
+int ImageCache::costOf(const Entry &e)
+{
+    qint64 bytes = e.image.sizeInBytes();
+    if (!e.pixmap.isNull())
+        bytes += qint64(e.pixmap.width()) * e.pixmap.height() * std::max(1, e.pixmap.depth()) / 8;
+    return int(std::max<qint64>(1, bytes / 1024));
+}
+
+bool ImageCache::entryCovers(const Entry &e, const QSize &target)
+{
+    if (e.image.size() == e.sourceSize) return true;   // full resolution
+    if (!target.isValid()) return false;
+
+    const QSize need = ImageDecoder::displaySize(e.sourceSize, target);
+    return e.image.width() >= need.width() && e.image.height() >= need.height();
+}
+
+bool ImageCache::covers(const QString &key, const QSize &target) const
+{
+    const Entry *e = cache.object(key);
+    return e && entryCovers(*e, target);
+}
+
+bool ImageCache::image(const QString &key, const QSize &target, QImage *out, QSize *sourceSize)
+{
+    Entry *e = cache.object(key);   // also bumps the entry to most-recent
+    if (!e || !entryCovers(*e, target)) {
+        ++missCount;
+        return false;
+    }
+    ++hitCount;
+    if (out) *out = e->image;
+    if (sourceSize) *sourceSize = e->sourceSize;
+    return true;
+}
+
+void ImageCache::insertImage(const QString &key, const QImage &img, const QSize &sourceSize)
+{
+    if (img.isNull()) return;
+
+    Entry *e = new Entry;
+    e->image = img;
+    e->sourceSize = sourceSize.isValid() ? sourceSize : img.size();
+    cache.insert(key, e, costOf(*e));
+}
+
+bool ImageCache::pixmap(const QString &key, const QSize &size, QPixmap *out) const
+{
+    const Entry *e = cache.object(key);
+    if (!e || e->pixmap.isNull()) return false;
+    if (e->pixmapSize != size) return false;
+    if (out) *out = e->pixmap;
+    return true;
+}
+
+void ImageCache::insertPixmap(const QString &key, const QSize &size, const QPixmap &pix)
+{
+    // Re-insert so the entry's cost reflects the pixmap it now carries.
+    Entry *e = cache.take(key);
+    if (!e) return;
+
+    e->pixmap = pix;
+    e->pixmapSize = size;
+    cache.insert(key, e, costOf(*e));
+}
+
+void ImageCache::clear()
+{
+    cache.clear();
+}
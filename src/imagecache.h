@@ -0,0 +1,63 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+// Byte-budgeted LRU of decoded images, keyed by path + mtime. Each entry can
+// also hold the label-sized pixmap last produced from it, so flipping back
+// to an image skips both the decode and the smooth rescale.
+//
+// Entries may hold a display-resolution decode; lookups pass the size the
+// caller needs (an invalid size meaning full resolution) and only count as
+// a hit if the cached image is large enough.
+//
+// GUI thread only (QPixmap).
+class ImageCache
+{
+public:
+    explicit ImageCache(qint64 budgetBytes = qint64(1024) * 1024 * 1024);
+
+    // Cache key for a file: absolute path plus last-modified time, so an
+    // image rewritten on disk is never served stale.
+    static QString keyFor(const QString &path);
+
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+    qint64 used() const;
+
+    // True if the entry can serve a display of `target` without upscaling.
+    bool covers(const QString &key, const QSize &target) const;
+
+    // Lookups that count towards the hit/miss statistics.
+    bool image(const QString &key, const QSize &target, QImage *out, QSize *sourceSize = nullptr);
+    void insertImage(const QString &key, const QImage &img, const QSize &sourceSize);
+
+    bool pixmap(const QString &key, const QSize &size, QPixmap *out) const;
+    void insertPixmap(const QString &key, const QSize &size, const QPixmap &pix);
+
+    void clear();
+
+    quint64 hits() const { return hitCount; }
+    quint64 misses() const { return missCount; }
+
+private:
+    struct Entry {
+        QImage image;
+        QSize sourceSize;           // dimensions stored in the file
+        QPixmap pixmap;
+        QSize pixmapSize;
+    };
+
+    static int costOf(const Entry &e);   // in KiB, QCache cost is an int
+    static bool entryCovers(const Entry &e, const QSize &target);
+
+    QCache<QString, Entry> cache;
+    quint64 hitCount = 0;
+    quint64 missCount = 0;
+};
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,131 @@
+#include "imagedecoder.h"
+
+#include <QDateTime>
+#include <QIODevice>
+#include <QImageReader>
+
+#include <cstring>
+
+namespace {
+
+const int kMaxSegments = 32;   // EXIF sits in the first few segments
+
+// ASCII date of a TIFF (EXIF) block: tag 0x9003 in the EXIF sub-IFD,
+// falling back to 0x0132 in IFD0.
+QByteArray tiffDateTime(const uchar *t, qint64 size)
+{
+    if (size < 8) return {};
+    const bool le = t[0] == 'I' && t[1] == 'I';
+    if (!le && !(t[0] == 'M' && t[1] == 'M')) return {};
+
+    auto u16 = [&](qint64 off) -> quint32 {
+        if (off < 0 || off + 2 > size) return 0;
+        return le ? quint32(t[off] | t[off + 1] << 8) : quint32(t[off] << 8 | t[off + 1]);
+    };
+    auto u32 = [&](qint64 off) -> quint32 {
+        return le ? u16(off) | u16(off + 2) << 16 : u16(off) << 16 | u16(off + 2);
+    };
+    auto ascii = [&](qint64 ifd, quint32 wanted, quint32 *exifIfd) -> QByteArray {
+        if (ifd <= 0 || ifd + 2 > size) return {};
+        const int count = int(u16(ifd));
+        QByteArray value;
+        for (int i = 0; i < count; ++i) {
+            const qint64 e = ifd + 2 + qint64(i) * 12;
+            if (e + 12 > size) break;
+            const quint32 tag = u16(e);
+            if (exifIfd && tag == 0x8769) *exifIfd = u32(e + 8);
+            if (tag != wanted || u16(e + 2) != 2) continue;   // 2: ASCII
+            const qint64 len = u32(e + 4);
+            const qint64 off = len <= 4 ? e + 8 : qint64(u32(e + 8));
+            if (off + len <= size) value = QByteArray(reinterpret_cast<const char *>(t + off), int(len));
+        }
+        return value;
+    };
+
+    quint32 exifIfd = 0;
+    const QByteArray modified = ascii(u32(4), 0x0132, &exifIfd);
+    const QByteArray original = ascii(exifIfd, 0x9003, nullptr);
+    return original.isEmpty() ? modified : original;
+}
+
+// Walks the JPEG marker segments from the current position, reading only
+// their 4-byte headers (and skipping the payloads) until the EXIF APP1.
+// Non-JPEGs cost a 2-byte read.
+QByteArray exifDateTime(QIODevice *device)
+{
+    uchar h[4];
+    auto readBytes = [device, &h](int n) { return device->read(reinterpret_cast<char *>(h), n) == n; };
+
+    if (!readBytes(2) || h[0] != 0xFF || h[1] != 0xD8) return {};   // SOI
+
+    for (int i = 0; i < kMaxSegments; ++i) {
+        if (!readBytes(2) || h[0] != 0xFF) return {};
+        uchar marker = h[1];
+        while (marker == 0xFF) {                                       // fill bytes
+            if (!readBytes(1)) return {};
+            marker = h[0];
+        }
+        if (marker == 0xDA || marker == 0xD9) return {};               // SOS / EOI
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+
+        if (!readBytes(2)) return {};
+        const qint64 len = (qint64(h[0]) << 8 | h[1]) - 2;
+        if (len < 0) return {};
+
+        if (marker == 0xE1 && len >= 14) {
+            const QByteArray app1 = device->read(len);
+            if (app1.size() != len) return {};
+            if (std::memcmp(app1.constData(), "Exif\0\0", 6) == 0)
+                return tiffDateTime(reinterpret_cast<const uchar *>(app1.constData()) + 6, len - 6);
+            continue;                                                  // XMP and the like
+        }
+        if (!device->seek(device->pos() + len)) return {};
+    }
+    return {};
+}
+
+} // namespace
+
+namespace ImageDecoder {
+
+QSize displaySize(const QSize &source, const QSize &target)
+{
+    if (!source.isValid() || !target.isValid() || target.isEmpty()) return source;
+
+    const QSize fit = source.scaled(target, Qt::KeepAspectRatio);
+    if (fit.width() >= source.width() || fit.height() >= source.height()) return source;
+    return fit.expandedTo(QSize(1, 1));
+}
+
+QImage decode(const QString &path, const QSize &target, QSize *sourceSize)
+{
+    QImageReader reader(path);
+
+    // Header-only: no pixel data is decoded yet.
+    const QSize src = reader.size();
+
+    if (src.isValid() && target.isValid()) {
+        const QSize want = displaySize(src, target);
+        // Formats without native support (PNG) are scaled by QImageReader
+        // itself, which still keeps the cached copy small.
+        if (want != src) reader.setScaledSize(want);
+    }
+
+    QImage img = reader.read();
+    if (sourceSize) *sourceSize = src.isValid() ? src : img.size();
+    return img;
+}
+
+qint64 captureTime(QIODevice *device)
+{
+    if (device->isSequential()) return 0;
+    const qint64 start = device->pos();
+    const QByteArray text = exifDateTime(device);
+    device->seek(start);
+
+    const QDateTime when = QDateTime::fromString(QString::fromLatin1(text.left(19)),
+                                                 QStringLiteral("yyyy:MM:dd HH:mm:ss"));
+    return when.isValid() ? when.toMSecsSinceEpoch() : 0;
+}
+
+} // namespace ImageDecoder
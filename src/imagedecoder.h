@@ -0,0 +1,30 @@
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+class QIODevice;
+
+// Decoding helpers shared by the GUI thread and the prefetch workers.
+// Thread-safe: they only use QImageReader.
+namespace ImageDecoder {
+
+// Size an image of `source` pixels should be decoded to so that it still
+// fills `target` with Qt::KeepAspectRatio. Never larger than `source`.
+QSize displaySize(const QSize &source, const QSize &target);
+
+// Decodes `path` straight to about `target` (JPEG uses DCT-domain scaling
+// through QImageReader::setScaledSize). An invalid `target` decodes at full
+// resolution. `sourceSize` receives the dimensions stored in the file.
+QImage decode(const QString &path, const QSize &target, QSize *sourceSize = nullptr);
+
+// EXIF DateTimeOriginal (DateTime if absent) of a JPEG, as local ms since
+// epoch; 0 if there is none. Reads segment headers up to the EXIF block
+// only (2 bytes for other formats) and restores the read position.
+qint64 captureTime(QIODevice *device);
+
+} // namespace ImageDecoder
+
+#endif // IMAGEDECODER_H
@@ -0,0 +1,86 @@
+#include "imageprefetcher.h"
+#include "imagecache.h"
+#include "imagedecoder.h"
+#include "profiler.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+ImagePrefetcher::ImagePrefetcher(ImageCache *cache, QObject *parent)
+    : QObject(parent)
+    , cache(cache)
+    , generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    pool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, 4));
+}
+
+ImagePrefetcher::~ImagePrefetcher()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    pool.waitForDone();
+}
+
+void ImagePrefetcher::setWindow(int ahead, int behind)
+{
+    aheadCount = std::max(0, ahead);
+    behindCount = std::max(0, behind);
+}
+
+void ImagePrefetcher::prefetch(const QDir &dir, const QStringList &names, int index, const QSize &target)
+{
+    // New generation: anything still queued for the old window is stale.
+    const quint64 gen = generation->fetch_add(1) + 1;
+    pool.clear();
+
+    window.clear();
+    if (index < 0 || index >= names.size()) return;
+
+    // Nearest neighbours first so the likely next step is decoded first.
+    QStringList wanted;
+    const int reach = std::max(aheadCount, behindCount);
+    for (int i = 1; i <= reach; ++i) {
+        if (i <= aheadCount && index + i < names.size())
+            wanted << dir.filePath(names.at(index + i));
+        if (i <= behindCount && index - i >= 0)
+            wanted << dir.filePath(names.at(index - i));
+    }
+    for (const QString &p : wanted) window.insert(p);
+
+    auto genRef = generation;
+    for (const QString &path : wanted) {
+        const QString key = ImageCache::keyFor(path);
+        if (cache->covers(key, target)) continue;
+
+        pool.start([this, genRef, gen, path, key, target]() {
+            if (genRef->load() != gen) return;
+
+            PROFILE_SCOPE("prefetch.decode");
+            QSize sourceSize;
+            const QImage img = ImageDecoder::decode(path, target, &sourceSize);
+
+            QMetaObject::invokeMethod(this, [this, path, key, img, sourceSize]() {
+                onDecoded(path, key, img, sourceSize);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void ImagePrefetcher::onDecoded(const QString &path, const QString &key, const QImage &img, const QSize &sourceSize)
+{
+    // Results from an older generation are still useful if the path is
+    // part of the current window (e.g. a short jump back and forth).
+    if (img.isNull() || !window.contains(path)) return;
+    if (cache->covers(key, img.size())) return;
+
+    cache->insertImage(key, img, sourceSize);
+    emit imageDecoded(path);
+}
+
+void ImagePrefetcher::clear()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    window.clear();
+}
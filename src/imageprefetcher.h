@@ -0,0 +1,53 @@
+#ifndef IMAGEPREFETCHER_H
+#define IMAGEPREFETCHER_H
+
+#include <QDir>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+class ImageCache;
+
+// Decodes the images around the current index on a worker pool so that
+// stepping to a neighbour does not block the GUI thread on QImage(path).
+// Decoded images are handed to the shared ImageCache.
+class ImagePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImagePrefetcher(ImageCache *cache, QObject *parent = nullptr);
+    ~ImagePrefetcher() override;
+
+    // Number of images decoded ahead of / behind the current one.
+    void setWindow(int ahead, int behind);
+
+    // Re-centres the ring on `index`. Queued jobs for the previous window
+    // are dropped. Images are decoded to fit `target` (invalid = full size).
+    void prefetch(const QDir &dir, const QStringList &names, int index, const QSize &target);
+
+    void clear();
+
+signals:
+    void imageDecoded(const QString &path);
+
+private:
+    void onDecoded(const QString &path, const QString &key, const QImage &img, const QSize &sourceSize);
+
+    ImageCache *cache = nullptr;
+    QThreadPool pool;
+    std::shared_ptr<std::atomic<quint64>> generation;
+
+    int aheadCount = 2;
+    int behindCount = 1;
+
+    QSet<QString> window;            // paths currently wanted
+};
+
+#endif // IMAGEPREFETCHER_H
@@ -0,0 +1,233 @@
+#include "imagesorter.h"
+#include "imagedecoder.h"
+#include "profiler.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QThread>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const int kChunk = 2048;
+
+const char *const kKeyNames[] = { "name", "natural", "mtime", "exif", "size", "boxes" };
+
+QString settingsKey(const QString &dirPath)
+{
+    const QFileInfo fi(dirPath);
+    const QString canonical = fi.canonicalFilePath().isEmpty() ? QDir(dirPath).absolutePath()
+                                                               : fi.canonicalFilePath();
+    const QByteArray id = QCryptographicHash::hash(canonical.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString("sort/dirs/%1").arg(QString::fromLatin1(id));
+}
+
+// Key of one image; only called for orders that need one.
+qint64 keyOf(const QDir &dir, const QString &name, const ImageOrder &order,
+             const DirectoryIndex &index, const LabelIndex &labels)
+{
+    if (order.key == ImageOrder::BoxCount) {
+        const int row = labels.rowOf(name);
+        return row < 0 ? 0 : labels.offsets.at(row + 1) - labels.offsets.at(row);
+    }
+
+    if (const DirectoryIndex::Entry *e = index.find(name)) {
+        switch (order.key) {
+        case ImageOrder::FileSize: return e->size;
+        case ImageOrder::CaptureTime: return e->captureTime > 0 ? e->captureTime : e->mtime;
+        default: return e->mtime;
+        }
+    }
+
+    // Not indexed yet (created since the last scan).
+    const QString path = dir.filePath(name);
+    const QFileInfo fi(path);
+    if (order.key == ImageOrder::FileSize) return fi.size();
+    if (order.key == ImageOrder::CaptureTime) {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            const qint64 t = ImageDecoder::captureTime(&file);
+            if (t > 0) return t;
+        }
+    }
+    return fi.lastModified().toMSecsSinceEpoch();
+}
+
+// Compares a digit run starting at `i` in `a` with one at `j` in `b` by
+// value (leading zeros ignored); advances both past their runs.
+int compareNumber(const QString &a, int &i, const QString &b, int &j)
+{
+    while (i < a.size() && a.at(i) == QLatin1Char('0') && i + 1 < a.size() && a.at(i + 1).isDigit()) ++i;
+    while (j < b.size() && b.at(j) == QLatin1Char('0') && j + 1 < b.size() && b.at(j + 1).isDigit()) ++j;
+    int ei = i, ej = j;
+    while (ei < a.size() && a.at(ei).isDigit()) ++ei;
+    while (ej < b.size() && b.at(ej).isDigit()) ++ej;
+
+    int result = (ei - i) - (ej - j);   // more digits: larger
+    for (int k = 0; result == 0 && k < ei - i; ++k)
+        result = a.at(i + k).unicode() - b.at(j + k).unicode();
+    i = ei;
+    j = ej;
+    return result;
+}
+
+} // namespace
+
+// ------------------------------------------------------------
+// ImageOrder
+// ------------------------------------------------------------
+QString ImageOrder::title(Key key)
+{
+    switch (key) {
+    case Name: return "Name";
+    case Natural: return "Name (Natural)";
+    case Modified: return "Modified Time";
+    case CaptureTime: return "Capture Time (EXIF)";
+    case FileSize: return "File Size";
+    case BoxCount: return "Box Count";
+    }
+    return QString();
+}
+
+QString ImageOrder::toString() const
+{
+    const QString name = QString::fromLatin1(kKeyNames[key]);
+    return descending ? name + "-desc" : name;
+}
+
+ImageOrder ImageOrder::fromString(const QString &text)
+{
+    ImageOrder order;
+    QString name = text;
+    if (name.endsWith("-desc")) {
+        order.descending = true;
+        name.chop(5);
+    }
+    for (int k = Name; k <= BoxCount; ++k) {
+        if (name == QLatin1String(kKeyNames[k])) order.key = Key(k);
+    }
+    return order;
+}
+
+ImageOrder ImageOrder::forDirectory(const QString &dirPath)
+{
+    QSettings settings;
+    const QString last = settings.value("sort/last").toString();
+    return fromString(settings.value(settingsKey(dirPath), last).toString());
+}
+
+void ImageOrder::setForDirectory(const QString &dirPath, const ImageOrder &order)
+{
+    QSettings settings;
+    settings.setValue(settingsKey(dirPath), order.toString());
+    settings.setValue("sort/last", order.toString());
+}
+
+// ------------------------------------------------------------
+// ImageSorter
+// ------------------------------------------------------------
+ImageSorter::ImageSorter(QObject *parent)
+    : QObject(parent)
+    , generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    pool.setMaxThreadCount(1);
+    keyPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+ImageSorter::~ImageSorter()
+{
+    cancel();
+    pool.waitForDone();
+    keyPool.waitForDone();
+}
+
+bool ImageSorter::naturalLess(const QString &a, const QString &b)
+{
+    int i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a.at(i).isDigit() && b.at(j).isDigit()) {
+            const int c = compareNumber(a, i, b, j);
+            if (c != 0) return c < 0;
+            continue;
+        }
+        const QChar ca = a.at(i).toLower(), cb = b.at(j).toLower();
+        if (ca != cb) return ca < cb;
+        ++i;
+        ++j;
+    }
+    if ((i < a.size()) != (j < b.size())) return j < b.size();
+    return a < b;   // equal ignoring case and zero padding
+}
+
+QStringList ImageSorter::sort(const QString &dirPath, const QStringList &names, const ImageOrder &order,
+                              const DirectoryIndex &index, const LabelIndex &labels, QThreadPool *pool)
+{
+    PROFILE_SCOPE("sort.images");
+
+    // Name order first: it is the tie-break of every other key.
+    QStringList out = names;
+    if (!std::is_sorted(out.cbegin(), out.cend())) std::sort(out.begin(), out.end());
+    if (order.key == ImageOrder::Name || order.key == ImageOrder::Natural) {
+        if (order.key == ImageOrder::Natural) std::sort(out.begin(), out.end(), &ImageSorter::naturalLess);
+        if (order.descending) std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+    // Keys in chunks, in parallel when a pool is given.
+    const QDir dir(dirPath);
+    const QStringList byName = out;
+    QVector<qint64> keys(byName.size());
+    qint64 *keyData = keys.data();   // detached once, written per chunk
+    auto chunk = [&](int first, int count) {
+        for (int i = first; i < first + count; ++i) keyData[i] = keyOf(dir, byName.at(i), order, index, labels);
+    };
+    for (int first = 0; first < byName.size(); first += kChunk) {
+        const int count = std::min(kChunk, int(byName.size()) - first);
+        if (pool) pool->start([&chunk, first, count]() { chunk(first, count); });
+        else chunk(first, count);
+    }
+    if (pool) pool->waitForDone();
+
+    QVector<int> rows(byName.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    const bool desc = order.descending;
+    std::stable_sort(rows.begin(), rows.end(), [&keys, desc](int a, int b) {
+        return desc ? keys.at(a) > keys.at(b) : keys.at(a) < keys.at(b);
+    });
+    for (int i = 0; i < rows.size(); ++i) out[i] = byName.at(rows.at(i));
+    return out;
+}
+
+void ImageSorter::start(const QString &dirPath, const QStringList &names, const ImageOrder &order,
+                        const DirectoryIndex &index, const LabelIndex &labels)
+{
+    const quint64 gen = generation->fetch_add(1) + 1;
+    pool.clear();
+    running = true;
+
+    auto genRef = generation;
+    QThreadPool *keys = &keyPool;
+    pool.start([this, genRef, gen, dirPath, names, order, index, labels, keys]() {
+        if (genRef->load() != gen) return;
+        const QStringList result = sort(dirPath, names, order, index, labels, keys);
+
+        QMetaObject::invokeMethod(this, [this, genRef, gen, dirPath, order, result]() {
+            if (genRef->load() != gen) return;
+            running = false;
+            emit sorted(dirPath, order, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ImageSorter::cancel()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    running = false;
+}
@@ -0,0 +1,75 @@
+#ifndef IMAGESORTER_H
+#define IMAGESORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "directoryindex.h"
+#include "labelindex.h"
+
+#include <atomic>
+#include <memory>
+
+// How the images of a directory are ordered. Name is plain QString order
+// (what the scanner delivers); Natural compares digit runs by value, so
+// img_2 comes before img_10.
+struct ImageOrder {
+    enum Key { Name, Natural, Modified, CaptureTime, FileSize, BoxCount };
+
+    Key key = Name;
+    bool descending = false;
+
+    bool isDefault() const { return key == Name && !descending; }
+    bool needsIndex() const { return key == Modified || key == CaptureTime || key == FileSize; }
+    bool needsLabels() const { return key == BoxCount; }
+    bool operator==(const ImageOrder &o) const { return key == o.key && descending == o.descending; }
+    bool operator!=(const ImageOrder &o) const { return !(*this == o); }
+
+    static QString title(Key key);
+    QString toString() const;                  // e.g. "natural", "mtime-desc"
+    static ImageOrder fromString(const QString &text);
+
+    // Kept per directory in QSettings; directories without a choice get the
+    // order picked last.
+    static ImageOrder forDirectory(const QString &dirPath);
+    static void setForDirectory(const QString &dirPath, const ImageOrder &order);
+};
+
+// Orders a directory listing on a background thread. Sort keys come from
+// the DirectoryIndex (size, mtime, EXIF time) and the LabelIndex (box
+// count); images missing from those (just created) are stat'ed or read in
+// parallel chunks. Ties keep name order.
+class ImageSorter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ImageSorter(QObject *parent = nullptr);
+    ~ImageSorter() override;
+
+    // `names` in any order. Starting again cancels a run.
+    void start(const QString &dirPath, const QStringList &names, const ImageOrder &order,
+               const DirectoryIndex &index, const LabelIndex &labels);
+    void cancel();
+    bool isRunning() const { return running; }
+
+    // Synchronous version; key chunks run on `pool` if given.
+    static QStringList sort(const QString &dirPath, const QStringList &names, const ImageOrder &order,
+                            const DirectoryIndex &index, const LabelIndex &labels,
+                            QThreadPool *pool = nullptr);
+
+    static bool naturalLess(const QString &a, const QString &b);
+
+signals:
+    void sorted(const QString &dirPath, const ImageOrder &order, const QStringList &names);
+
+private:
+    QThreadPool pool;          // one sort at a time
+    QThreadPool keyPool;       // key chunks
+    std::shared_ptr<std::atomic<quint64>> generation;
+    bool running = false;
+};
+
+#endif // IMAGESORTER_H
@@ -0,0 +1,151 @@
+#include "imageview.h"
+#include "profiler.h"
+
+#include <QHash>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QStyle>
+
+#include <algorithm>
+
+ImageView::ImageView(QWidget *parent)
+    : QLabel(parent)
+{
+}
+
+void ImageView::setPixmap(const QPixmap &pixmap)
+{
+    shown = pixmap;
+    QLabel::setPixmap(pixmap);
+}
+
+void ImageView::setText(const QString &text)
+{
+    shown = QPixmap();
+    annotations.clear();
+    QLabel::setText(text);
+}
+
+void ImageView::setAnnotations(const QVector<YoloLabel> &labels)
+{
+    annotations = labels;
+    std::stable_sort(annotations.begin(), annotations.end(),
+                     [](const YoloLabel &a, const YoloLabel &b) { return a.confidence > b.confidence; });
+    if (showOverlay) update();
+}
+
+void ImageView::setMinConfidence(float threshold)
+{
+    if (minConf == threshold) return;
+    minConf = threshold;
+    if (showOverlay) update();
+}
+
+void ImageView::setHiddenClasses(const QSet<int> &classes)
+{
+    if (hidden == classes) return;
+    hidden = classes;
+    if (showOverlay) update();
+}
+
+int ImageView::visibleCount() const
+{
+    const auto end = std::partition_point(annotations.cbegin(), annotations.cend(),
+                                          [this](const YoloLabel &a) { return a.confidence >= minConf; });
+    return int(end - annotations.cbegin());
+}
+
+QMap<int, int> ImageView::classCounts() const
+{
+    QMap<int, int> counts;
+    for (int i = 0, n = visibleCount(); i < n; ++i) ++counts[annotations.at(i).classId];
+    return counts;
+}
+
+void ImageView::setOverlayVisible(bool visible)
+{
+    if (showOverlay == visible) return;
+    showOverlay = visible;
+    update();
+}
+
+void ImageView::setClassColors(const QMap<int, QColor> &colors)
+{
+    classColors = colors;
+}
+
+void ImageView::setClassNameProvider(std::function<QString(int)> provider)
+{
+    className = std::move(provider);
+}
+
+void ImageView::paintEvent(QPaintEvent *event)
+{
+    PROFILE_SCOPE("view.paint");
+    QLabel::paintEvent(event);
+
+    if (!showOverlay || annotations.isEmpty() || shown.isNull()) return;
+
+    // Same placement QLabel uses for the pixmap.
+    const QSize logical = shown.size() / shown.devicePixelRatio();
+    const QRect imageRect = QStyle::alignedRect(layoutDirection(), alignment(), logical, contentsRect());
+
+    QPainter p(this);
+    paintOverlay(p, imageRect);
+}
+
+void ImageView::paintOverlay(QPainter &p, const QRectF &r) const
+{
+    // Axis-aligned rectangles gain nothing from antialiasing.
+    p.setRenderHint(QPainter::Antialiasing, false);
+    p.setBrush(Qt::NoBrush);
+
+    const int kMaxTags = 200;
+    const double kMinTagWidth = 40.0;
+    const double kMinTagHeight = 16.0;
+
+    QMap<int, QVector<QRectF>> boxesByClass;
+    QVector<int> tagged;   // annotation indices, most confident first
+    for (int i = 0, n = visibleCount(); i < n; ++i) {
+        const YoloLabel &a = annotations.at(i);
+        if (hidden.contains(a.classId)) continue;
+
+        const QRectF box(r.left() + (a.xCenter - a.width / 2.0) * r.width(),
+                         r.top() + (a.yCenter - a.height / 2.0) * r.height(),
+                         a.width * r.width(),
+                         a.height * r.height());
+        boxesByClass[a.classId] << box;
+        if (tagged.size() < kMaxTags && box.width() >= kMinTagWidth && box.height() >= kMinTagHeight)
+            tagged << i;
+    }
+
+    for (auto it = boxesByClass.cbegin(); it != boxesByClass.cend(); ++it) {
+        const QColor c = classColors.contains(it.key()) ? classColors.value(it.key()) : QColor("#00FF00");
+        p.setPen(QPen(c, 2));
+        p.drawRects(it.value());
+    }
+    if (tagged.isEmpty()) return;
+
+    QFont font = p.font();
+    font.setBold(true);
+    font.setPointSize(9);
+    p.setFont(font);
+    p.setPen(Qt::white);
+
+    QHash<int, QString> names;
+    for (int i : tagged) {
+        const YoloLabel &a = annotations.at(i);
+        auto name = names.find(a.classId);
+        if (name == names.end())
+            name = names.insert(a.classId, className ? className(a.classId) : QString("Class %1").arg(a.classId));
+
+        QString label = name.value();
+        if (a.hasConfidence) label += QString(" (%1)").arg(a.confidence, 0, 'f', 2);
+
+        const double left = r.left() + (a.xCenter - a.width / 2.0) * r.width();
+        const double top = r.top() + (a.yCenter - a.height / 2.0) * r.height();
+        const QRectF tag(left, top - 18, std::max(60.0, double(a.width * r.width())), 18);
+        p.fillRect(tag, QColor(0, 0, 0, 140));
+        p.drawText(tag.adjusted(4, 0, 0, 0), Qt::AlignVCenter, label);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef IMAGEVIEW_H
+#define IMAGEVIEW_H
+
+#include <QLabel>
+#include <QMap>
+#include <QPixmap>
+#include <QSet>
+#include <QVector>
+
+#include <functional>
+
+#include "yololabels.h"
+
+// The image label. Shows the (already label-sized) pixmap like a QLabel and
+// paints YOLO boxes on top of it at display resolution, so the source image
+// is never copied and toggling the overlay is just a repaint.
+//
+// Annotations are kept sorted by descending confidence, so the confidence
+// threshold is a binary search for the visible prefix. Boxes are drawn with
+// one drawRects() per class colour; labels are only drawn for boxes large
+// enough to carry one, most confident first, up to a fixed budget.
+class ImageView : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit ImageView(QWidget *parent = nullptr);
+
+    // Hide QLabel's versions so the shown pixmap is tracked here.
+    void setPixmap(const QPixmap &pixmap);
+    void setText(const QString &text);
+    bool hasImage() const { return !shown.isNull(); }
+
+    void setAnnotations(const QVector<YoloLabel> &labels);
+    void setOverlayVisible(bool visible);
+    bool overlayVisible() const { return showOverlay; }
+
+    // Boxes below `threshold` or of a hidden class are not drawn.
+    // Ground-truth boxes (no confidence column) count as 1 and stay visible.
+    void setMinConfidence(float threshold);
+    float minConfidence() const { return minConf; }
+    void setHiddenClasses(const QSet<int> &classes);
+    const QSet<int> &hiddenClasses() const { return hidden; }
+
+    // Boxes passing the threshold (hidden classes included), per class.
+    QMap<int, int> classCounts() const;
+
+    void setClassColors(const QMap<int, QColor> &colors);
+    void setClassNameProvider(std::function<QString(int)> provider);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void paintOverlay(QPainter &p, const QRectF &imageRect) const;
+    int visibleCount() const;
+
+    QPixmap shown;
+    QVector<YoloLabel> annotations;   // normalized, by descending confidence
+    bool showOverlay = false;
+    float minConf = 0.0f;
+    QSet<int> hidden;
+
+    QMap<int, QColor> classColors;
+    std::function<QString(int)> className;
+};
+
+#endif // IMAGEVIEW_H
@@ -0,0 +1,135 @@
+#include "labelindex.h"
+#include "directoryindex.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace {
+const quint32 kMagic = 0x41494c42;   // "AILB"
+const quint16 kVersion = 2;   // 2: missing confidence stored as 1
+}
+
+QString LabelIndex::indexFilePath(const QString &dirPath)
+{
+    QString path = DirectoryIndex::indexFilePath(dirPath);
+    path.chop(QStringLiteral(".idx").size());
+    return path + QStringLiteral(".labels");
+}
+
+bool LabelIndex::load(const QString &path)
+{
+    *this = LabelIndex();
+    dirPath = path;
+
+    QFile f(indexFilePath(path));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_12);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString storedPath;
+    in >> magic >> version;
+    if (magic != kMagic || version != kVersion) return false;
+
+    in >> storedPath >> names >> labelMtimes >> offsets
+       >> classIds >> xCenters >> yCenters >> widths >> heights >> confidences;
+
+    const int boxes = classIds.size();
+    const bool consistent = labelMtimes.size() == names.size() && offsets.size() == names.size() + 1
+                            && offsets.last() == boxes && xCenters.size() == boxes && yCenters.size() == boxes
+                            && widths.size() == boxes && heights.size() == boxes && confidences.size() == boxes;
+    if (in.status() != QDataStream::Ok || !consistent) {
+        *this = LabelIndex();
+        dirPath = path;
+        return false;
+    }
+    return true;
+}
+
+bool LabelIndex::save() const
+{
+    const QString file = indexFilePath(dirPath);
+    QDir().mkpath(QFileInfo(file).absolutePath());
+
+    QSaveFile f(file);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_12);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << kMagic << kVersion << QDir(dirPath).absolutePath() << names << labelMtimes << offsets
+        << classIds << xCenters << yCenters << widths << heights << confidences;
+
+    return f.commit();
+}
+
+int LabelIndex::rowOf(const QString &name) const
+{
+    const auto it = std::lower_bound(names.cbegin(), names.cend(), name);
+    if (it == names.cend() || *it != name) return -1;
+    return int(it - names.cbegin());
+}
+
+bool LabelIndex::matches(int row, const LabelFilter &filter) const
+{
+    for (int b = offsets.at(row), end = offsets.at(row + 1); b < end; ++b) {
+        if (confidences.at(b) < filter.minConfidence) continue;
+        if (filter.classes.isEmpty() || filter.classes.contains(classIds.at(b))) return true;
+    }
+    return false;
+}
+
+QVector<LabelIndex::ClassStats> LabelIndex::classStats() const
+{
+    // Dense counters for the usual small class ids, a hash for the rest.
+    const int kDense = 4096;
+    QVector<ClassStats> dense(kDense);
+    QVector<int> lastRow(kDense, -1);
+    QHash<int, ClassStats> sparse;
+    QHash<int, int> sparseLastRow;
+
+    for (int row = 0; row < names.size(); ++row) {
+        for (int b = offsets.at(row), end = offsets.at(row + 1); b < end; ++b) {
+            const int c = classIds.at(b);
+            if (c >= 0 && c < kDense) {
+                ++dense[c].boxes;
+                if (lastRow.at(c) != row) {
+                    lastRow[c] = row;
+                    ++dense[c].images;
+                }
+            } else {
+                ClassStats &s = sparse[c];
+                ++s.boxes;
+                int &last = sparseLastRow[c];
+                if (s.images == 0 || last != row) {
+                    last = row;
+                    ++s.images;
+                }
+            }
+        }
+    }
+
+    QVector<ClassStats> out;
+    for (auto it = sparse.cbegin(); it != sparse.cend(); ++it) {
+        ClassStats s = it.value();
+        s.classId = it.key();
+        out << s;
+    }
+    for (int c = 0; c < kDense; ++c) {
+        if (dense.at(c).boxes == 0) continue;
+        ClassStats s = dense.at(c);
+        s.classId = c;
+        out << s;
+    }
+    std::sort(out.begin(), out.end(), [](const ClassStats &a, const ClassStats &b) { return a.classId < b.classId; });
+    return out;
+}
@@ -0,0 +1,62 @@
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Which images navigation stops at: an image matches if at least one of its
+// boxes has one of `classes` (any class if empty) with a confidence of at
+// least `minConfidence`. Boxes without a confidence column (ground truth)
+// count as 1, so a threshold never hides them.
+struct LabelFilter {
+    QSet<int> classes;
+    float minConfidence = 0.0f;
+
+    bool isActive() const { return !classes.isEmpty() || minConfidence > 0.0f; }
+};
+
+// Every YOLO box of a directory, stored column-wise: one row per image
+// (sorted by name) and one entry per box in each box column, with
+// `offsets` marking where an image's boxes start. Persisted next to the
+// DirectoryIndex and rebuilt incrementally by LabelIndexer, which only
+// re-parses label files whose mtime changed.
+class LabelIndex
+{
+public:
+    struct ClassStats {
+        int classId = -1;
+        qint64 boxes = 0;
+        qint64 images = 0;      // images with at least one such box
+    };
+
+    static QString indexFilePath(const QString &dirPath);
+
+    bool load(const QString &dirPath);
+    bool save() const;
+
+    bool isEmpty() const { return names.isEmpty(); }
+    int imageCount() const { return names.size(); }
+    qint64 boxCount() const { return classIds.size(); }
+
+    // Binary search in `names`; -1 if the image is not indexed.
+    int rowOf(const QString &name) const;
+    bool matches(int row, const LabelFilter &filter) const;
+
+    // Sorted by class id; one pass over the class column.
+    QVector<ClassStats> classStats() const;
+
+    QString dirPath;
+    QStringList names;
+    QVector<qint64> labelMtimes;   // per image, -1: no label file
+    QVector<qint32> offsets;       // per image + 1, into the box columns
+    QVector<qint32> classIds;
+    QVector<float> xCenters;
+    QVector<float> yCenters;
+    QVector<float> widths;
+    QVector<float> heights;
+    QVector<float> confidences;
+};
+
+#endif // LABELINDEX_H
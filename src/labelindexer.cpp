@@ -0,0 +1,145 @@
+#include "labelindexer.h"
+#include "profiler.h"
+#include "yololabels.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+
+const int kChunk = 512;
+
+// Rows [first, first + count) of the new index, built by one worker.
+struct Chunk {
+    QVector<qint64> mtimes;
+    QVector<qint32> counts;
+    QVector<qint32> classIds;
+    QVector<float> xCenters, yCenters, widths, heights, confidences;
+};
+
+void indexChunk(const QDir &dir, const QStringList &names, int first, int count,
+                const LabelIndex &previous, Chunk &out)
+{
+    QByteArray buffer;
+    QVector<YoloLabel> labels;
+    for (int i = first; i < first + count; ++i) {
+        const QString &name = names.at(i);
+        const QFileInfo txt(YoloLabels::labelPathFor(dir.filePath(name)));
+        const qint64 mtime = txt.exists() ? txt.lastModified().toMSecsSinceEpoch() : -1;
+        out.mtimes << mtime;
+
+        // Unchanged label file: copy its boxes from the previous index.
+        const int prev = previous.rowOf(name);
+        if (prev >= 0 && previous.labelMtimes.at(prev) == mtime) {
+            const int b = previous.offsets.at(prev), e = previous.offsets.at(prev + 1);
+            out.counts << (e - b);
+            out.classIds += previous.classIds.mid(b, e - b);
+            out.xCenters += previous.xCenters.mid(b, e - b);
+            out.yCenters += previous.yCenters.mid(b, e - b);
+            out.widths += previous.widths.mid(b, e - b);
+            out.heights += previous.heights.mid(b, e - b);
+            out.confidences += previous.confidences.mid(b, e - b);
+            continue;
+        }
+
+        if (mtime < 0 || !YoloLabels::readFile(txt.filePath(), buffer, labels)) labels.clear();
+        out.counts << labels.size();
+        for (const YoloLabel &l : labels) {
+            out.classIds << l.classId;
+            out.xCenters << l.xCenter;
+            out.yCenters << l.yCenter;
+            out.widths << l.width;
+            out.heights << l.height;
+            out.confidences << l.confidence;
+        }
+    }
+}
+
+} // namespace
+
+LabelIndexer::LabelIndexer(QObject *parent)
+    : QObject(parent)
+    , generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    pool.setMaxThreadCount(1);
+    parsePool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+LabelIndexer::~LabelIndexer()
+{
+    cancel();
+    pool.waitForDone();
+    parsePool.waitForDone();
+}
+
+void LabelIndexer::start(const QString &dirPath, const QStringList &names)
+{
+    const quint64 gen = generation->fetch_add(1) + 1;
+    pool.clear();
+    parsePool.clear();
+    running = true;
+
+    auto genRef = generation;
+    QThreadPool *parsers = &parsePool;
+    pool.start([this, genRef, gen, dirPath, names, parsers]() {
+        PROFILE_SCOPE("labels.index");
+
+        LabelIndex previous;
+        previous.load(dirPath);
+
+        // Names arrive sorted like QDir::Name, which rowOf() relies on.
+        QStringList sorted = names;
+        std::sort(sorted.begin(), sorted.end());
+
+        const QDir dir(dirPath);
+        const int chunks = (sorted.size() + kChunk - 1) / kChunk;
+        QVector<Chunk> parts(chunks);
+        for (int c = 0; c < chunks; ++c) {
+            Chunk *part = &parts[c];
+            const int first = c * kChunk;
+            const int count = std::min(kChunk, int(sorted.size()) - first);
+            parsers->start([genRef, gen, &dir, &sorted, &previous, part, first, count]() {
+                if (genRef->load() != gen) return;
+                indexChunk(dir, sorted, first, count, previous, *part);
+            });
+        }
+        parsers->waitForDone();
+        if (genRef->load() != gen) return;
+
+        LabelIndex index;
+        index.dirPath = dirPath;
+        index.names = sorted;
+        index.labelMtimes.reserve(sorted.size());
+        index.offsets.reserve(sorted.size() + 1);
+        index.offsets << 0;
+        for (const Chunk &part : parts) {
+            index.labelMtimes += part.mtimes;
+            for (qint32 n : part.counts) index.offsets << index.offsets.last() + n;
+            index.classIds += part.classIds;
+            index.xCenters += part.xCenters;
+            index.yCenters += part.yCenters;
+            index.widths += part.widths;
+            index.heights += part.heights;
+            index.confidences += part.confidences;
+        }
+        index.save();
+
+        QMetaObject::invokeMethod(this, [this, genRef, gen, index]() {
+            if (genRef->load() != gen) return;
+            running = false;
+            emit ready(index);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LabelIndexer::cancel()
+{
+    generation->fetch_add(1);
+    pool.clear();
+    parsePool.clear();
+    running = false;
+}
@@ -0,0 +1,40 @@
+#ifndef LABELINDEXER_H
+#define LABELINDEXER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "labelindex.h"
+
+#include <atomic>
+#include <memory>
+
+// Builds the LabelIndex of a directory in the background. The persisted
+// index is loaded first; label files are then stat'ed and, where the mtime
+// changed, parsed in parallel chunks. The result is saved and delivered
+// through ready().
+class LabelIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LabelIndexer(QObject *parent = nullptr);
+    ~LabelIndexer() override;
+
+    // `names` are the directory's images; starting again cancels a run.
+    void start(const QString &dirPath, const QStringList &names);
+    void cancel();
+    bool isRunning() const { return running; }
+
+signals:
+    void ready(const LabelIndex &index);
+
+private:
+    QThreadPool pool;          // one coordinating job at a time
+    QThreadPool parsePool;     // label chunks
+    std::shared_ptr<std::atomic<quint64>> generation;
+    bool running = false;
+};
+
+#endif // LABELINDEXER_H
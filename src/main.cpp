@@ -1,8 +1,20 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include "headless.h"
 #include "mainwindow.h"
 
 int main(int argc, char *argv[]) {
+    // Batch jobs must not need a display, so no QApplication for them.
+    if (Headless::requested(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        app.setOrganizationName("AI_ImageSuite");
+        app.setApplicationName("AI_ImageSuite");
+        return Headless::run(app.arguments());
+    }
+
     QApplication app(argc, argv);
+    app.setOrganizationName("AI_ImageSuite");
+    app.setApplicationName("AI_ImageSuite");
 
     MainWindow window;
     window.show();
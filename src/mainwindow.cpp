@@ -1,27 +1,55 @@
 #include "mainwindow.h"
+#include "categoryjournal.h"
+#include "categorylistmodel.h"
+#include "directorypreloader.h"
+#include "directoryscanner.h"
+#include "eventlog.h"
+#include "filmstripmodel.h"
+#include "imagedecoder.h"
+#include "imageprefetcher.h"
+#include "imageview.h"
+#include "labelindexer.h"
+#include "profiler.h"
+#include "profilerhud.h"
+#include "siblingdirectories.h"
+#include "thumbnailcache.h"
+#include "transferengine.h"
+#include "yololabels.h"
 
 #include <QAction>
+#include <QActionGroup>
 #include <QDateTime>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QEventLoop>
 #include <QFileDialog>
 #include <QGroupBox>
+#include <QHash>
 #include <QHeaderView>
+#include <QInputDialog>
 #include <QKeyEvent>
+#include <QListView>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QPainter>
 #include <QPixmap>
+#include <QPointer>
+#include <QProgressDialog>
 #include <QResizeEvent>
-#include <QRegularExpression>
+#include <QSet>
+#include <QSettings>
 #include <QStatusBar>
 #include <QTableWidget>
+#include <QThreadPool>
 #include <QVBoxLayout>
 #include <QSize>
+#include <QStandardPaths>
 #include <QStyle>
 #include <QUrl>
 #include <QDesktopServices>
+#include <QTimer>
 #include <QToolBar>
 
 #include <algorithm>
@@ -134,9 +162,32 @@ MainWindow::MainWindow(QWidget *parent)
     titleLabel->setStyleSheet("QLabel { font-size: 24px; font-weight: bold; color: #003366; }");
 
     // Image view
-    imageLabel = new QLabel(this);
+    imageLabel = new ImageView(this);
     imageLabel->setAlignment(Qt::AlignCenter);
     imageLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    imageLabel->setClassColors(classColors);
+    imageLabel->setClassNameProvider([this](int classId) { return getClassName(classId); });
+    profilerHud = new ProfilerHud(imageLabel);
+    profilerHud->hide();
+
+    // Filmstrip (virtualized: only visible rows request thumbnails)
+    thumbnails = new ThumbnailCache(this);
+    filmstripModel = new FilmstripModel(thumbnails, this);
+    filmstrip = new QListView(this);
+    filmstrip->setModel(filmstripModel);
+    filmstrip->setFlow(QListView::LeftToRight);
+    filmstrip->setWrapping(false);
+    filmstrip->setUniformItemSizes(true);
+    filmstrip->setLayoutMode(QListView::Batched);
+    filmstrip->setBatchSize(256);
+    filmstrip->setIconSize(QSize(96, 72));
+    filmstrip->setSpacing(2);
+    filmstrip->setFixedHeight(100);
+    filmstrip->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    filmstrip->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    filmstrip->setSelectionMode(QAbstractItemView::SingleSelection);
+    filmstrip->setFocusPolicy(Qt::NoFocus);   // arrow keys keep navigating images
+    filmstrip->setStyleSheet("QListView { background-color: #eeeeee; }");
 
     // Info label (center below image)
     infoLabel = new QLabel(this);
@@ -175,6 +226,11 @@ MainWindow::MainWindow(QWidget *parent)
     imageSlider->setPageStep(1);
     imageSlider->setTickPosition(QSlider::TicksBelow);
 
+    // Image cache hit/miss counters (left of the index)
+    cacheLabel = new QLabel(this);
+    cacheLabel->setObjectName("cacheLabel");
+    statusBar()->addPermanentWidget(cacheLabel, 0);
+
     // Bottom-right index (re-integrated)
     indexLabel = new QLabel("0 / 0", this);
     indexLabel->setObjectName("indexLabel");
@@ -205,6 +261,13 @@ MainWindow::MainWindow(QWidget *parent)
     categoryTabs = new QTabWidget(this);
     categoryTabs->setFixedWidth(320);
 
+    // Tags from the previous session (journal + snapshots)
+    savedListsDir = QSettings().value("lists/saveDir").toString();
+    journal = new CategoryJournal(&categoryStore, CategoryJournal::defaultDirectory(), this);
+    journal->setListsDirectory(savedListsDir);
+    const int restoredTags = journal->replay();
+    connect(journal, &CategoryJournal::compacted, this, &MainWindow::onCategoryListsCompacted);
+
     // Default category
     ensureDefaultCategory();
     rebuildCategoryTabs();
@@ -220,6 +283,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     QVBoxLayout *imageCol = new QVBoxLayout();
     imageCol->addWidget(imageLabel, 1);
+    imageCol->addWidget(filmstrip);
     imageCol->addWidget(imageSlider);
     imageCol->addLayout(navRow);
     imageCol->addWidget(infoLabel);
@@ -269,7 +333,43 @@ rightPanel->addWidget(lastSavedLabel);
     QAction *openDir = new QAction("Open Directory", this);
     connect(openDir, &QAction::triggered, this, &MainWindow::openImageDirectory);
     fileMenu->addAction(openDir);
+    QAction *cacheBudget = new QAction("Image Cache Size...", this);
+    connect(cacheBudget, &QAction::triggered, this, &MainWindow::configureImageCacheBudget);
+    fileMenu->addAction(cacheBudget);
     mb->addMenu(fileMenu);
+
+    // Stage timings (see Profiler)
+    QMenu *viewMenu = new QMenu("View", mb);
+    QAction *hudAction = new QAction("Latency HUD", this);
+    hudAction->setCheckable(true);
+    hudAction->setShortcut(QKeySequence(Qt::Key_F12));
+    connect(hudAction, &QAction::toggled, this, [this](bool on) {
+        profilerHud->move(8, 8);
+        profilerHud->setVisible(on);
+    });
+    viewMenu->addAction(hudAction);
+    QAction *traceAction = new QAction("Capture Trace", this);
+    traceAction->setCheckable(true);
+    connect(traceAction, &QAction::toggled, this, [](bool on) { Profiler::instance().setTraceCapture(on); });
+    viewMenu->addAction(traceAction);
+    QAction *exportTrace = new QAction("Export Chrome Trace...", this);
+    connect(exportTrace, &QAction::triggered, this, &MainWindow::exportProfilerTrace);
+    viewMenu->addAction(exportTrace);
+    QAction *resetTimings = new QAction("Reset Timings", this);
+    connect(resetTimings, &QAction::triggered, this, []() { Profiler::instance().reset(); });
+    viewMenu->addAction(resetTimings);
+    viewMenu->addSeparator();
+    QAction *filterAction = new QAction("Label Filter...", this);
+    filterAction->setShortcut(QKeySequence("Ctrl+F"));
+    connect(filterAction, &QAction::triggered, this, &MainWindow::openLabelFilter);
+    viewMenu->addAction(filterAction);
+    QAction *clearFilter = new QAction("Clear Label Filter", this);
+    connect(clearFilter, &QAction::triggered, this, [this]() { setLabelFilter(LabelFilter()); });
+    viewMenu->addAction(clearFilter);
+    viewMenu->addSeparator();
+    QMenu *sortMenu = viewMenu->addMenu("Sort By");
+    connect(sortMenu, &QMenu::aboutToShow, this, [this, sortMenu]() { populateSortMenu(sortMenu); });
+    mb->addMenu(viewMenu);
     setMenuBar(mb);
 
     // ------------------------------------------------------------
@@ -334,6 +434,33 @@ rightPanel->addWidget(lastSavedLabel);
     QPushButton *tbLoadNames = makeTbBtn("Load Names", QStyle::SP_FileIcon, "Load .names file for class labels");
     topBar->addWidget(tbLoadNames);
 
+    // Overlay filtering at render time: confidence threshold, class visibility
+    topBar->addWidget(new QLabel(" Min conf ", this));
+    QSlider *confSlider = new QSlider(Qt::Horizontal, this);
+    confSlider->setRange(0, 100);
+    confSlider->setFixedWidth(120);
+    confSlider->setFocusPolicy(Qt::NoFocus);
+    confSlider->setToolTip("Hide boxes below this confidence");
+    topBar->addWidget(confSlider);
+    QLabel *confValue = new QLabel("0.00 ", this);
+    topBar->addWidget(confValue);
+
+    QPushButton *tbClasses = makeTbBtn("Classes", QStyle::SP_FileDialogDetailedView, "Show or hide boxes per class");
+    QMenu *classesMenu = new QMenu(tbClasses);
+    tbClasses->setMenu(classesMenu);
+    topBar->addWidget(tbClasses);
+
+    connect(confSlider, &QSlider::valueChanged, this, [this, confValue](int v) {
+        const float threshold = v / 100.0f;
+        confValue->setText(QString::number(threshold, 'f', 2) + " ");
+        imageLabel->setMinConfidence(threshold);
+        QSettings().setValue("overlay/minConfidence", v);
+    });
+    confSlider->setValue(QSettings().value("overlay/minConfidence", 0).toInt());
+    connect(classesMenu, &QMenu::aboutToShow, this, [this, classesMenu]() {
+        populateClassVisibilityMenu(classesMenu);
+    });
+
     auto syncTbYoloToggle = [this, tbYoloToggle]() {
         if (showYoloBoundingBoxes) {
             tbYoloToggle->setStyleSheet(
@@ -379,12 +506,51 @@ rightPanel->addWidget(lastSavedLabel);
     connect(leftButton, &QPushButton::clicked, this, &MainWindow::showPreviousImage);
     connect(rightButton, &QPushButton::clicked, this, &MainWindow::showNextImage);
 
+    // Slider: while dragging only cheap thumbnail previews are shown and the
+    // full image is loaded once the slider settles; other value changes
+    // (wheel, page steps, filmstrip clicks) are coalesced per event loop pass.
+    scrubSettleTimer = new QTimer(this);
+    scrubSettleTimer->setSingleShot(true);
+    scrubSettleTimer->setInterval(150);
+    imageUpdateTimer = new QTimer(this);
+    imageUpdateTimer->setSingleShot(true);
+    imageUpdateTimer->setInterval(0);
+    connect(scrubSettleTimer, &QTimer::timeout, this, &MainWindow::updateImage);
+    connect(imageUpdateTimer, &QTimer::timeout, this, &MainWindow::updateImage);
+
     connect(imageSlider, &QSlider::valueChanged, this, [this](int v){
         if (imageList.isEmpty()) return;
-        v = std::clamp(v, 0, imageList.size()-1);
-        currentImageIndex = v;
+        if (labelFilterEngaged()) {
+            if (filteredRows.isEmpty()) return;
+            currentImageIndex = filteredRows.at(std::clamp(v, 0, filteredRows.size() - 1));
+        } else {
+            currentImageIndex = std::clamp(v, 0, imageList.size() - 1);
+        }
+        if (imageSlider->isSliderDown()) {
+            showScrubPreview();
+            scrubSettleTimer->start();
+        } else {
+            imageUpdateTimer->start();
+        }
+    });
+    connect(imageSlider, &QSlider::sliderReleased, this, [this](){
+        thumbnails->dropLatest();
+        scrubSettleTimer->stop();
+        imageUpdateTimer->stop();
         updateImage();
     });
+    connect(thumbnails, &ThumbnailCache::thumbnailReady, this, [this](const QString &path){
+        if (!imageSlider->isSliderDown() || imageList.isEmpty()) return;
+        if (path == directory.filePath(imageList.at(currentImageIndex))) showScrubPreview();
+    });
+
+    connect(filmstrip, &QListView::clicked, this, [this](const QModelIndex &idx){
+        if (!idx.isValid()) return;
+        currentImageIndex = idx.row();
+        syncSlider();
+        imageUpdateTimer->start();
+        setFocus();
+    });
 
     connect(configureTaggingButton, &QPushButton::clicked, this, &MainWindow::openTaggingConfig);
 
@@ -400,13 +566,87 @@ rightPanel->addWidget(lastSavedLabel);
     connect(toggleYoloButton, &QPushButton::clicked, this, &MainWindow::toggleYoloBoundingBoxes);
     connect(loadNamesButton, &QPushButton::clicked, this, &MainWindow::on_loadNamesFileButton_clicked);
 
+    // Decoded image cache (budget persisted across sessions)
+    const int cacheMB = QSettings().value("cache/imageBudgetMB", 1024).toInt();
+    imageCache.setBudget(qint64(std::max(64, cacheMB)) * 1024 * 1024);
+    updateCacheStatusLabel();
+
+    // Background directory listing
+    scanner = new DirectoryScanner(this);
+    connect(scanner, &DirectoryScanner::batchReady, this, &MainWindow::onDirectoryBatch);
+    connect(scanner, &DirectoryScanner::finished, this, &MainWindow::onDirectoryScanned);
+    connect(scanner, &DirectoryScanner::indexReady, this, [this](const DirectoryIndex &index) {
+        dirIndex = index;
+        updateFolderDateTimeLabel();
+        if (sortOrder.needsIndex()) resortImages();
+    });
+
+    // Sort keys other than the name are applied in the background.
+    sorter = new ImageSorter(this);
+    connect(sorter, &ImageSorter::sorted, this, &MainWindow::onImagesSorted);
+
+    // Sibling folder stepping: cached listing, next folder warmed up in the
+    // background once the current one has been scanned.
+    siblings = new SiblingDirectories(this);
+    preloader = new DirectoryPreloader(&imageCache, this);
+    preloadTimer = new QTimer(this);
+    preloadTimer->setSingleShot(true);
+    preloadTimer->setInterval(500);
+    connect(preloadTimer, &QTimer::timeout, this, &MainWindow::preloadNextDirectory);
+    connect(siblings, &SiblingDirectories::changed, preloadTimer, qOverload<>(&QTimer::start));
+
+    // Per-directory YOLO box index for class / confidence filtering
+    labelIndexer = new LabelIndexer(this);
+    connect(labelIndexer, &LabelIndexer::ready, this, &MainWindow::onLabelIndexReady);
+    labelRefreshTimer = new QTimer(this);
+    labelRefreshTimer->setSingleShot(true);
+    labelRefreshTimer->setInterval(1000);
+    connect(labelRefreshTimer, &QTimer::timeout, this, [this]() {
+        if (scanner->isRunning()) return;
+        labelIndexer->start(directory.absolutePath(), imageList);
+        if (orderStale && !sortOrder.needsLabels()) resortImages();
+    });
+
+    // Live file events for the current directory and every directory that
+    // holds tagged paths; a full re-list only when events were lost.
+    watcher = new DirectoryWatcher(this);
+    connect(watcher, &DirectoryWatcher::changed, this, &MainWindow::onDirectoryChanges);
+    connect(watcher, &DirectoryWatcher::rescanNeeded, this, &MainWindow::resyncWithDisk);
+    connect(watcher, &DirectoryWatcher::directoryRemoved, this, [this](const QString &dir) {
+        watcher->unwatch(dir);
+        taggedDirs.remove(dir);
+        siblings->invalidate();
+        resyncWithDisk();
+    });
+
+    // Bulk copy / move
+    transfers = new TransferEngine(this);
+
+    // Background decoding of neighbouring images
+    prefetcher = new ImagePrefetcher(&imageCache, this);
+    prefetcher->setWindow(2, 1);
+
     // Logging
     const QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
     const QString logName = QString("log_%1.txt").arg(timestamp);
-    logFile.setFileName(logName);
-    if (logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        logStream.setDevice(&logFile);
+    events = new EventLog(this);
+    events->open(EventLog::defaultDirectory(), qint64(16) * 1024 * 1024, 500);   // ~a year of daily sessions
+
+    if (activityLog.open(logName)) {
         logActivity("Application started.");
+        if (restoredTags > 0) logActivity(QString("Restored %1 tagged images from journal.").arg(restoredTags));
+    }
+    if (!journal->isOwner()) {
+        logActivity("Tag journal in use by " + journal->lockHolder() + "; tags will not be saved.");
+        QMessageBox::warning(this, "Tags",
+                             QString("The tag journal is in use by %1.\n"
+                                     "Tags changed in this window will not be saved.")
+                                 .arg(journal->lockHolder()));
+    }
+
+    // Folders holding tagged paths are watched for the whole session.
+    for (const QString &cat : categoryStore.categories()) {
+        for (const QString &p : categoryStore.paths(cat)) watchDirectoryOf(p);
     }
 
     // Startup: prompt for folder
@@ -421,9 +661,11 @@ rightPanel->addWidget(lastSavedLabel);
 
 MainWindow::~MainWindow()
 {
-    if (logFile.isOpen()) {
+    journal->flush();
+
+    if (activityLog.isOpen()) {
         logActivity("Application closed.");
-        logFile.close();
+        activityLog.close();
     }
 }
 
@@ -472,21 +714,47 @@ void MainWindow::loadImagesFromDirectory()
 bool MainWindow::loadImagesFromDirectoryPath(const QString &dirPath, bool logIt)
 {
     if (dirPath.isEmpty()) return false;
+    PROFILE_SCOPE("loadDir");
 
+    const QString previous = directory.path().isEmpty() ? QString() : directory.absolutePath();
     directory.setPath(dirPath);
-
-    QStringList filters;
-    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.JPG" << "*.JPEG" << "*.PNG";
-
-    imageList = directory.entryList(filters, QDir::Files, QDir::Name);
+    if (!previous.isEmpty() && previous != directory.absolutePath() && !taggedDirs.contains(previous))
+        watcher->unwatch(previous);
+    watcher->watch(directory.absolutePath());
+    liveAdded.clear();
+    liveRemoved.clear();
+    labelRefreshTimer->stop();
+    sorter->cancel();
+    sortOrder = ImageOrder::forDirectory(directory.absolutePath());
+    orderedDir.clear();
+    orderStale = false;
+    prefetcher->clear();
+
+    // The listing streams in from the scanner (onDirectoryBatch / onDirectoryScanned);
+    // the first images can be browsed before the scan has finished.
+    imageList.clear();
     currentImageIndex = 0;
-
-    imageSlider->setRange(0, std::max(0, imageList.size() - 1));
-    imageSlider->blockSignals(true);
-    imageSlider->setValue(currentImageIndex);
-    imageSlider->blockSignals(false);
-
-    indexLabel->setText(imageList.isEmpty() ? "0 / 0" : QString("1 / %1").arg(imageList.size()));
+    eventIndex = -1;
+    dirLoadClock.start();
+    dirLoadPending = true;
+    dirIndex = DirectoryIndex();
+    labelIndexer->cancel();
+    labelIndex = LabelIndex();
+    annotationsPath.clear();   // reload re-reads the labels (mtime-checked)
+    filteredRows.clear();
+    preloadTimer->stop();
+
+    // A preloaded listing is shown right away; the scan then only confirms
+    // it (from the index the preloader refreshed) instead of streaming.
+    QStringList preloaded;
+    const bool havePreloaded = preloader->take(directory.absolutePath(), &preloaded);
+    if (havePreloaded) imageList = preloaded;
+    filmstripModel->setImages(directory, imageList);
+    scanner->start(directory.absolutePath(), !havePreloaded);
+
+    syncSlider();
+
+    indexLabel->setText("0 / 0");
 
     updateDirectoryNameLabel();
 
@@ -499,100 +767,138 @@ bool MainWindow::loadImagesFromDirectoryPath(const QString &dirPath, bool logIt)
     return true;
 }
 
-QStringList MainWindow::siblingDirectories(QString *outCurrentName) const
+void MainWindow::onDirectoryBatch(const QStringList &names)
 {
-    // Return sibling directory NAMES under the parent of the current image directory,
-    // sorted by name (QDir::Name). Also returns the current directory name.
-    const QString curAbs = directory.absolutePath();
-    if (curAbs.isEmpty()) return {};
+    PROFILE_SCOPE("loadDir.batch");
+    const bool wasEmpty = imageList.isEmpty();
+    imageList += names;
+    filmstripModel->appendImages(names);
+    syncSlider();
+
+    if (wasEmpty) {
+        currentImageIndex = 0;
+        updateFolderDateTimeLabel();
+        updateImage();
+    } else {
+        updateIndexLabel();
+    }
+}
 
-    // Canonical path helps avoid mismatch due to symlinks/trailing slashes.
-    const QString curCanonical = QFileInfo(curAbs).canonicalFilePath().isEmpty()
-                                     ? QDir(curAbs).absolutePath()
-                                     : QFileInfo(curAbs).canonicalFilePath();
+void MainWindow::onDirectoryScanned(const QStringList &sortedNames)
+{
+    PROFILE_SCOPE("loadDir.apply");
+    // Stay on the image being viewed; batches arrived in readdir order.
+    QString keep;
+    if (!imageList.isEmpty())
+        keep = imageList.at(std::clamp(currentImageIndex, 0, imageList.size() - 1));
+
+    QStringList listing = sortedNames;
+
+    // Files that came or went while the scan ran may be missing from (or
+    // still in) its listing.
+    if (!liveRemoved.isEmpty()) {
+        listing.erase(std::remove_if(listing.begin(), listing.end(),
+                                     [this](const QString &n) { return liveRemoved.contains(n); }),
+                      listing.end());
+    }
+    for (const QString &name : qAsConst(liveAdded)) {
+        const auto it = std::lower_bound(listing.begin(), listing.end(), name);
+        if (it == listing.end() || *it != name) listing.insert(it, name);
+    }
+    liveAdded.clear();
+    liveRemoved.clear();
 
-    QFileInfo curInfo(curCanonical);
-    const QString curName = curInfo.fileName();
-    if (outCurrentName) *outCurrentName = curName;
+    // A rescan of a sorted list keeps its order; new names go last until
+    // the sorter places them.
+    if (listIsNameSorted()) {
+        imageList = listing;
+    } else {
+        const QSet<QString> present(listing.cbegin(), listing.cend());
+        QSet<QString> known;
+        QStringList kept;
+        kept.reserve(listing.size());
+        for (const QString &name : qAsConst(imageList)) {
+            if (present.contains(name)) { kept << name; known.insert(name); }
+        }
+        for (const QString &name : qAsConst(listing)) {
+            if (!known.contains(name)) { kept << name; orderStale = true; }
+        }
+        imageList = kept;
+    }
+    filmstripModel->setImages(directory, imageList);
 
-    QDir parentDir = curInfo.dir(); // parent of current directory
-    if (!parentDir.exists()) return {};
+    int idx = std::min(currentImageIndex, imageList.size() - 1);
+    if (!keep.isEmpty()) {
+        const int row = rowOfImage(keep);
+        if (row >= 0) idx = row;
+    }
+    currentImageIndex = std::max(0, idx);
+
+    // The old index still serves the filter until the new one is ready.
+    rebuildFilteredRows();
+    syncSlider();
+    labelIndexer->start(directory.absolutePath(), imageList);
+    resortImages();
+    preloadTimer->start();
+
+    if (dirLoadPending) {
+        dirLoadPending = false;
+        events->loadDir(directory.absolutePath(), imageList.size(), dirLoadClock.elapsed());
+    }
 
-    // List sibling directories (names only)
-    QStringList dirs = parentDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
-    return dirs;
+    updateFolderDateTimeLabel();
+    updateImage();
+    logActivity(QString("Directory scan finished: %1 images").arg(imageList.size()));
 }
 
 void MainWindow::showPreviousDirectory()
 {
-    QString curName;
-    const QStringList dirs = siblingDirectories(&curName);
-    if (dirs.isEmpty() || curName.isEmpty()) return;
+    switchToSiblingDirectory(-1);
+}
 
-    int idx = dirs.indexOf(curName);
-    if (idx < 0) {
-        // If the name doesn't match, try matching by canonical path basename
-        const QString base = QFileInfo(directory.absolutePath()).fileName();
-        idx = dirs.indexOf(base);
-    }
-    if (idx <= 0) return;
+void MainWindow::showNextDirectory()
+{
+    switchToSiblingDirectory(1);
+}
 
-    const QString curAbs = directory.absolutePath();
-    const QString curCanonical = QFileInfo(curAbs).canonicalFilePath().isEmpty()
-                                     ? QDir(curAbs).absolutePath()
-                                     : QFileInfo(curAbs).canonicalFilePath();
-    QDir parentDir = QFileInfo(curCanonical).dir(); // parent of current directory
+void MainWindow::switchToSiblingDirectory(int step)
+{
+    const QString target = siblings->neighbour(directory.absolutePath(), step);
+    if (target.isEmpty()) return;
 
-    const QString target = parentDir.filePath(dirs[idx - 1]);
+    lastDirectoryStep = step;
     if (!loadImagesFromDirectoryPath(target, true)) return;
-
     pruneMissingFiles();
-    rebuildCategoryTabs();
-    updateImage();
 }
 
-void MainWindow::showNextDirectory()
+void MainWindow::preloadNextDirectory()
 {
-    QString curName;
-    const QStringList dirs = siblingDirectories(&curName);
-    if (dirs.isEmpty() || curName.isEmpty()) return;
-
-    int idx = dirs.indexOf(curName);
-    if (idx < 0) {
-        const QString base = QFileInfo(directory.absolutePath()).fileName();
-        idx = dirs.indexOf(base);
+    // Keep walking in the direction the user last went.
+    const QString next = siblings->neighbour(directory.absolutePath(), lastDirectoryStep);
+    if (next.isEmpty()) {
+        preloader->cancel();
+        return;
     }
-    if (idx < 0 || idx >= dirs.size() - 1) return;
-
-    const QString curAbs = directory.absolutePath();
-    const QString curCanonical = QFileInfo(curAbs).canonicalFilePath().isEmpty()
-                                     ? QDir(curAbs).absolutePath()
-                                     : QFileInfo(curAbs).canonicalFilePath();
-    QDir parentDir = QFileInfo(curCanonical).dir(); // parent of current directory
-
-    const QString target = parentDir.filePath(dirs[idx + 1]);
-    if (!loadImagesFromDirectoryPath(target, true)) return;
-
-    pruneMissingFiles();
-    rebuildCategoryTabs();
-    updateImage();
+    preloader->preload(next, displayDecodeSize());
 }
 
 void MainWindow::openImageDirectory()
 {
     loadImagesFromDirectory();
     pruneMissingFiles();
-    rebuildCategoryTabs();
     updateImage();
 }void MainWindow::showPreviousImage()
 {
     if (imageList.isEmpty()) return;
 
-    if (currentImageIndex > 0) {
-        --currentImageIndex;
-        imageSlider->blockSignals(true);
-        imageSlider->setValue(currentImageIndex);
-        imageSlider->blockSignals(false);
+    int target = currentImageIndex - 1;
+    if (labelFilterEngaged()) {
+        const auto it = std::lower_bound(filteredRows.cbegin(), filteredRows.cend(), currentImageIndex);
+        target = it == filteredRows.cbegin() ? -1 : *(it - 1);
+    }
+    if (target >= 0) {
+        currentImageIndex = target;
+        syncSlider();
         updateImage();
         logActivity("Navigated to previous image.");
     }
@@ -602,23 +908,176 @@ void MainWindow::showNextImage()
 {
     if (imageList.isEmpty()) return;
 
-    if (currentImageIndex < imageList.size() - 1) {
-        ++currentImageIndex;
-        imageSlider->blockSignals(true);
-        imageSlider->setValue(currentImageIndex);
-        imageSlider->blockSignals(false);
+    int target = currentImageIndex + 1;
+    if (labelFilterEngaged()) {
+        const auto it = std::upper_bound(filteredRows.cbegin(), filteredRows.cend(), currentImageIndex);
+        target = it == filteredRows.cend() ? imageList.size() : *it;
+    }
+    if (target < imageList.size()) {
+        currentImageIndex = target;
+        syncSlider();
         updateImage();
         logActivity("Navigated to next image.");
     }
 }
 
+// ------------------------------------------------------------
+// Label filter (class / confidence navigation)
+// ------------------------------------------------------------
+bool MainWindow::labelFilterEngaged() const
+{
+    // Until the directory's labels are indexed every image is shown.
+    return labelFilter.isActive() && !labelIndex.isEmpty();
+}
+
+void MainWindow::rebuildFilteredRows()
+{
+    filteredRows.clear();
+    if (!labelFilterEngaged()) return;
+
+    for (int i = 0; i < imageList.size(); ++i) {
+        const int row = labelIndex.rowOf(imageList.at(i));
+        if (row >= 0 && labelIndex.matches(row, labelFilter)) filteredRows << i;
+    }
+}
+
+void MainWindow::syncSlider()
+{
+    // With a label filter the slider only walks the matching images.
+    int count = imageList.size();
+    int pos = currentImageIndex;
+    if (labelFilterEngaged()) {
+        count = filteredRows.size();
+        pos = int(std::lower_bound(filteredRows.cbegin(), filteredRows.cend(), currentImageIndex)
+                  - filteredRows.cbegin());
+    }
+
+    imageSlider->blockSignals(true);
+    imageSlider->setRange(0, std::max(0, count - 1));
+    imageSlider->setValue(std::clamp(pos, 0, std::max(0, count - 1)));
+    imageSlider->blockSignals(false);
+}
+
+void MainWindow::setLabelFilter(const LabelFilter &filter)
+{
+    labelFilter = filter;
+    rebuildFilteredRows();
+
+    // Land on the first match at or after the current image.
+    if (labelFilterEngaged() && !filteredRows.isEmpty()) {
+        const auto it = std::lower_bound(filteredRows.cbegin(), filteredRows.cend(), currentImageIndex);
+        currentImageIndex = it == filteredRows.cend() ? filteredRows.last() : *it;
+    }
+    syncSlider();
+    updateImage();
+
+    if (labelFilter.isActive())
+        logActivity(QString("Label filter: %1 of %2 images match.").arg(filteredRows.size()).arg(imageList.size()));
+    else
+        logActivity("Label filter cleared.");
+}
+
+void MainWindow::onLabelIndexReady(const LabelIndex &index)
+{
+    if (QDir(index.dirPath).absolutePath() != directory.absolutePath()) return;
+
+    const bool wasEngaged = labelFilterEngaged();
+    labelIndex = index;
+    logActivity(QString("Indexed %1 boxes in %2 images.").arg(index.boxCount()).arg(index.imageCount()));
+
+    if (labelFilter.isActive() && !wasEngaged) {
+        setLabelFilter(labelFilter);   // the filter now takes effect
+    } else {
+        rebuildFilteredRows();
+        syncSlider();
+        updateIndexLabel();
+    }
+    if (sortOrder.needsLabels()) resortImages();
+}
+
+void MainWindow::openLabelFilter()
+{
+    if (labelIndex.isEmpty()) {
+        QMessageBox::information(this, "Label Filter",
+                                 labelIndexer->isRunning() ? "Labels are still being indexed."
+                                                           : "No labels indexed for this directory.");
+        return;
+    }
+
+    QElapsedTimer statsClock;
+    statsClock.start();
+    const QVector<LabelIndex::ClassStats> stats = labelIndex.classStats();
+    const qint64 statsMs = statsClock.elapsed();
+
+    QDialog dlg(this);
+    dlg.setWindowTitle("Label Filter");
+    QVBoxLayout *layout = new QVBoxLayout(&dlg);
+    layout->addWidget(new QLabel(QString("%1 images, %2 boxes (counted in %3 ms).\n"
+                                         "Navigation and the slider stop only at images with a checked class.\n"
+                                         "No class checked: any class.")
+                                     .arg(labelIndex.imageCount()).arg(labelIndex.boxCount()).arg(statsMs),
+                                 &dlg));
+
+    QTableWidget *table = new QTableWidget(int(stats.size()), 3, &dlg);
+    table->setHorizontalHeaderLabels({"Class", "Boxes", "Images"});
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    for (int r = 0; r < stats.size(); ++r) {
+        const LabelIndex::ClassStats &s = stats.at(r);
+        QTableWidgetItem *cls = new QTableWidgetItem(QString("%1: %2").arg(s.classId).arg(getClassName(s.classId)));
+        cls->setFlags(Qt::ItemIsEnabled | Qt::ItemIsUserCheckable);
+        cls->setCheckState(labelFilter.classes.contains(s.classId) ? Qt::Checked : Qt::Unchecked);
+        cls->setData(Qt::UserRole, s.classId);
+        table->setItem(r, 0, cls);
+        table->setItem(r, 1, new QTableWidgetItem(QString::number(s.boxes)));
+        table->setItem(r, 2, new QTableWidgetItem(QString::number(s.images)));
+    }
+    table->resizeColumnsToContents();
+    layout->addWidget(table);
+
+    QHBoxLayout *confRow = new QHBoxLayout();
+    confRow->addWidget(new QLabel("Minimum confidence:", &dlg));
+    QDoubleSpinBox *minConf = new QDoubleSpinBox(&dlg);
+    minConf->setRange(0.0, 1.0);
+    minConf->setSingleStep(0.05);
+    minConf->setDecimals(2);
+    minConf->setValue(labelFilter.minConfidence);
+    confRow->addWidget(minConf);
+    confRow->addStretch();
+    layout->addLayout(confRow);
+
+    QDialogButtonBox *bb = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel
+                                                | QDialogButtonBox::Reset, &dlg);
+    layout->addWidget(bb);
+    connect(bb, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    connect(bb, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    connect(bb->button(QDialogButtonBox::Reset), &QPushButton::clicked, &dlg, [table, minConf]() {
+        for (int r = 0; r < table->rowCount(); ++r) table->item(r, 0)->setCheckState(Qt::Unchecked);
+        minConf->setValue(0.0);
+    });
+
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    LabelFilter filter;
+    for (int r = 0; r < table->rowCount(); ++r) {
+        if (table->item(r, 0)->checkState() == Qt::Checked)
+            filter.classes.insert(table->item(r, 0)->data(Qt::UserRole).toInt());
+    }
+    filter.minConfidence = float(minConf->value());
+    setLabelFilter(filter);
+    setFocus();
+}
+
 // ------------------------------------------------------------
 // Image refresh (draw + info + counters)
 // ------------------------------------------------------------
 void MainWindow::updateImage()
 {
+    PROFILE_SCOPE("updateImage");
+
     if (imageList.isEmpty()) {
-        imageLabel->setText("No images loaded.");
+        imageLabel->setText(scanner->isRunning() ? "Scanning directory..." : "No images loaded.");
         infoLabel->clear();
         indexLabel->setText("0 / 0");
         return;
@@ -628,22 +1087,51 @@ void MainWindow::updateImage()
 
     const QString imagePath = directory.filePath(imageList.at(currentImageIndex));
 
-    currentImage = QImage(imagePath);
+    if (currentImageIndex != eventIndex) {
+        eventIndex = currentImageIndex;
+        imageShownClock.start();
+        events->navigate(currentImageIndex, imageList.size());
+    }
+
+    // Neighbours are decoded ahead of time by the prefetcher; only a cold
+    // image (first one, or after a jump) is decoded here on the GUI thread.
+    const QSize decodeTarget = displayDecodeSize();
+    QString cacheKey;
+    {
+        PROFILE_SCOPE("image.cacheLookup");
+        cacheKey = ImageCache::keyFor(imagePath);
+    }
+    if (!imageCache.image(cacheKey, decodeTarget, &currentImage, &currentImageSize)) {
+        PROFILE_SCOPE("image.decode");
+        currentImage = ImageDecoder::decode(imagePath, decodeTarget, &currentImageSize);
+        imageCache.insertImage(cacheKey, currentImage, currentImageSize);
+    }
+    {
+        PROFILE_SCOPE("prefetch.schedule");
+        prefetcher->prefetch(directory, imageList, currentImageIndex, decodeTarget);
+    }
+    updateCacheStatusLabel();
+
     if (currentImage.isNull()) {
         imageLabel->setText("Failed to load image.");
         return;
     }
 
-    loadYOLOAnnotations(imagePath);
-
-    QImage display = currentImage;
-    if (showYoloBoundingBoxes) {
-        display = renderBoundingBoxesOn(display);
+    QPixmap pix;
+    if (!imageCache.pixmap(cacheKey, imageLabel->size(), &pix)) {
+        PROFILE_SCOPE("pixmap.scale");
+        pix = QPixmap::fromImage(currentImage);
+        pix = pix.scaled(imageLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        imageCache.insertPixmap(cacheKey, imageLabel->size(), pix);
+    }
+    {
+        PROFILE_SCOPE("label.setPixmap");
+        imageLabel->setPixmap(pix);
     }
 
-    QPixmap pix = QPixmap::fromImage(display);
-    pix = pix.scaled(imageLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    imageLabel->setPixmap(pix);
+    // Boxes are painted by the view on top of the pixmap.
+    if (showYoloBoundingBoxes) loadYOLOAnnotations(imagePath);
+    imageLabel->setAnnotations(showYoloBoundingBoxes ? currentAnnotations : QVector<YoloLabel>());
 
     const QFileInfo fi(imagePath);
     const QString folderAbs = directory.absolutePath();
@@ -651,10 +1139,89 @@ void MainWindow::updateImage()
     infoLabel->setText(QString("%1\nFolder: %2\n%3 x %4")
                            .arg(fi.fileName())
                            .arg(folderBase)
-                           .arg(currentImage.width())
-                           .arg(currentImage.height()));
+                           .arg(currentImageSize.width())
+                           .arg(currentImageSize.height()));
+
+    updateIndexLabel();
+    syncFilmstrip();
+}
+
+void MainWindow::syncFilmstrip()
+{
+    PROFILE_SCOPE("filmstrip.sync");
+
+    const QModelIndex idx = filmstripModel->index(currentImageIndex);
+    if (!idx.isValid()) return;
+    filmstrip->selectionModel()->setCurrentIndex(idx, QItemSelectionModel::ClearAndSelect);
+    filmstrip->scrollTo(idx, QAbstractItemView::PositionAtCenter);
+}
+
+void MainWindow::updateIndexLabel()
+{
+    if (labelFilterEngaged()) {
+        const auto it = std::lower_bound(filteredRows.cbegin(), filteredRows.cend(), currentImageIndex);
+        const bool onMatch = it != filteredRows.cend() && *it == currentImageIndex;
+        indexLabel->setText(QString("%1 / %2 filtered (%3 of %4)")
+                                .arg(onMatch ? QString::number(it - filteredRows.cbegin() + 1) : QString("-"))
+                                .arg(filteredRows.size())
+                                .arg(imageList.isEmpty() ? 0 : currentImageIndex + 1)
+                                .arg(imageList.size()));
+        return;
+    }
 
-    indexLabel->setText(QString("%1 / %2").arg(currentImageIndex + 1).arg(imageList.size()));
+    // "+" while the directory scan is still adding images.
+    indexLabel->setText(QString("%1 / %2%3")
+                            .arg(imageList.isEmpty() ? 0 : currentImageIndex + 1)
+                            .arg(imageList.size())
+                            .arg(scanner->isRunning() ? "+" : ""));
+}
+
+void MainWindow::showScrubPreview()
+{
+    // O(1) per slider step: a memory lookup and a fast scale of a thumbnail.
+    // Only the newest missing thumbnail is generated, shown on arrival.
+    const QString imagePath = directory.filePath(imageList.at(currentImageIndex));
+    QPixmap thumb;
+    if (thumbnails->requestLatest(imagePath, &thumb)) {
+        imageLabel->setPixmap(thumb.scaled(imageLabel->size(), Qt::KeepAspectRatio, Qt::FastTransformation));
+        imageLabel->setAnnotations({});
+    }
+
+    infoLabel->setText(QFileInfo(imagePath).fileName());
+    updateIndexLabel();
+}
+
+QSize MainWindow::displayDecodeSize() const
+{
+    // Boxes are drawn by the view at display resolution, so the image only
+    // ever needs to be decoded to the label size.
+    return imageLabel->size();
+}
+
+void MainWindow::updateCacheStatusLabel()
+{
+    if (!cacheLabel) return;
+    cacheLabel->setText(QString("Cache: %1 hit / %2 miss (%3 / %4 MB)")
+                            .arg(imageCache.hits())
+                            .arg(imageCache.misses())
+                            .arg(imageCache.used() / (1024 * 1024))
+                            .arg(imageCache.budget() / (1024 * 1024)));
+}
+
+void MainWindow::configureImageCacheBudget()
+{
+    bool ok = false;
+    const int current = int(imageCache.budget() / (1024 * 1024));
+    const int mb = QInputDialog::getInt(this, "Image Cache Size",
+                                        "Memory budget for decoded images (MB):",
+                                        current, 64, 65536, 64, &ok);
+    if (!ok) return;
+
+    imageCache.setBudget(qint64(mb) * 1024 * 1024);
+    QSettings().setValue("cache/imageBudgetMB", mb);
+    updateCacheStatusLabel();
+    logActivity(QString("Image cache budget set to %1 MB").arg(mb));
+    setFocus();
 }
 
 // ------------------------------------------------------------
@@ -688,93 +1255,68 @@ void MainWindow::on_loadNamesFileButton_clicked()
     const QString file = QFileDialog::getOpenFileName(this, "Select .names file", "", "Names (*.names);;All (*)");
     if (file.isEmpty()) return;
     loadClassNames(file);
-    updateImage();
+    imageLabel->update();
 }
 
 void MainWindow::loadYOLOAnnotations(const QString &imagePath)
 {
-    currentAnnotations.clear();
-
-    QFileInfo fi(imagePath);
-    const QString txtPath = fi.dir().filePath(fi.completeBaseName() + ".txt");
-    QFile f(txtPath);
-    if (!f.exists()) return;
-    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return;
-
-    QTextStream in(&f);
-    const int W = currentImage.width();
-    const int H = currentImage.height();
+    // Normalized labels only depend on the file, so a refresh for the same
+    // image (YOLO toggle, resize) reuses them without touching the disk.
+    if (imagePath == annotationsPath) return;
 
-    while (!in.atEnd()) {
-        const QString line = in.readLine().trimmed();
-        if (line.isEmpty()) continue;
-
-        const QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (parts.size() < 5) continue;
-
-        bool ok0=false, ok1=false, ok2=false, ok3=false, ok4=false, ok5=true;
-        int cls = parts[0].toInt(&ok0);
-        double xc = parts[1].toDouble(&ok1);
-        double yc = parts[2].toDouble(&ok2);
-        double ww = parts[3].toDouble(&ok3);
-        double hh = parts[4].toDouble(&ok4);
-        float conf = 0.0f;
-        if (parts.size() >= 6) conf = parts[5].toFloat(&ok5);
-
-        if (!(ok0 && ok1 && ok2 && ok3 && ok4 && ok5)) continue;
+    PROFILE_SCOPE("annotations.load");
+    currentAnnotations = annotationCache.labelsFor(imagePath);
+    annotationsPath = imagePath;
+}
 
-        const int x = int((xc - ww/2.0) * W);
-        const int y = int((yc - hh/2.0) * H);
-        const int w = int(ww * W);
-        const int h = int(hh * H);
+void MainWindow::toggleYoloBoundingBoxes()
+{
+    showYoloBoundingBoxes = !showYoloBoundingBoxes;
+    updateToggleYoloButtonStyle();
 
-        Annotation a;
-        a.classId = cls;
-        a.className = getClassName(cls);
-        a.confidence = conf;
-        a.boundingBox = QRect(x, y, w, h);
-        currentAnnotations.push_back(a);
+    // Only the overlay changes: no decode, no rescale, no image copy.
+    if (showYoloBoundingBoxes && !imageList.isEmpty() && imageLabel->hasImage()) {
+        loadYOLOAnnotations(directory.filePath(imageList.at(currentImageIndex)));
+        imageLabel->setAnnotations(currentAnnotations);
     }
-
-    f.close();
+    imageLabel->setOverlayVisible(showYoloBoundingBoxes);
+    logActivity(QString("YOLO bounding boxes %1").arg(showYoloBoundingBoxes ? "ON" : "OFF"));
 }
 
-QImage MainWindow::renderBoundingBoxesOn(const QImage &img) const
+void MainWindow::populateClassVisibilityMenu(QMenu *menu)
 {
-    QImage out = img.copy();
-    QPainter p(&out);
-    p.setRenderHint(QPainter::Antialiasing, true);
-
-    for (const auto &a : currentAnnotations) {
-        QColor c = classColors.contains(a.classId) ? classColors.value(a.classId) : QColor("#00FF00");
-        QPen pen(c, 3);
-        p.setPen(pen);
-        p.drawRect(a.boundingBox);
-
-        QString label = a.className;
-        if (a.confidence > 0.0f) label += QString(" (%1)").arg(a.confidence, 0, 'f', 2);
-
-        QFont font = p.font();
-        font.setBold(true);
-        font.setPointSize(10);
-        p.setFont(font);
-
-        const QRect r = a.boundingBox.adjusted(0, -22, 0, 0);
-        p.fillRect(QRect(r.left(), r.top(), std::max(60, r.width()), 20), QColor(0, 0, 0, 140));
-        p.setPen(Qt::white);
-        p.drawText(QRect(r.left()+4, r.top(), std::max(60, r.width()), 20), Qt::AlignVCenter, label);
+    menu->clear();
+
+    // Classes on the current image above the threshold, plus hidden ones so
+    // they can be shown again.
+    const QMap<int, int> counts = imageLabel->classCounts();
+    QSet<int> hidden = imageLabel->hiddenClasses();
+    QList<int> ids = counts.keys();
+    for (int id : hidden) {
+        if (!counts.contains(id)) ids << id;
     }
+    std::sort(ids.begin(), ids.end());
 
-    p.end();
-    return out;
-}
+    QAction *showAll = menu->addAction("Show All Classes");
+    showAll->setEnabled(!hidden.isEmpty());
+    connect(showAll, &QAction::triggered, this, [this]() { imageLabel->setHiddenClasses({}); });
+    menu->addSeparator();
 
-void MainWindow::toggleYoloBoundingBoxes()
-{
-    showYoloBoundingBoxes = !showYoloBoundingBoxes;
-    updateToggleYoloButtonStyle();
-    updateImage();
-    logActivity(QString("YOLO bounding boxes %1").arg(showYoloBoundingBoxes ? "ON" : "OFF"));
+    if (ids.isEmpty()) {
+        menu->addAction("No boxes on this image")->setEnabled(false);
+        return;
+    }
+    for (int id : ids) {
+        QAction *a = menu->addAction(QString("%1: %2 (%3)").arg(id).arg(getClassName(id)).arg(counts.value(id)));
+        a->setCheckable(true);
+        a->setChecked(!hidden.contains(id));
+        connect(a, &QAction::toggled, this, [this, id](bool visible) {
+            QSet<int> h = imageLabel->hiddenClasses();
+            if (visible) h.remove(id);
+            else h.insert(id);
+            imageLabel->setHiddenClasses(h);
+        });
+    }
 }
 
 // ------------------------------------------------------------
@@ -783,7 +1325,7 @@ void MainWindow::toggleYoloBoundingBoxes()
 void MainWindow::ensureDefaultCategory()
 {
     const QString def = "Uncategorized";
-    if (!categoryPaths.contains(def)) categoryPaths[def] = QStringList();
+    categoryStore.addCategory(def);
 }
 
 QString MainWindow::currentCategory() const
@@ -794,10 +1336,13 @@ QString MainWindow::currentCategory() const
 
 void MainWindow::rebuildCategoryTabs()
 {
+    // Views and models only reference the store, so this costs one view per
+    // tab regardless of how many paths are tagged.
+    for (QListView *v : qAsConst(categoryWidgets)) v->deleteLater();
     categoryTabs->clear();
     categoryWidgets.clear();
 
-    QStringList cats = categoryPaths.keys();
+    QStringList cats = categoryStore.categories();
     cats.removeAll("Uncategorized");
     std::sort(cats.begin(), cats.end(), [](const QString &a, const QString &b){
         return a.toLower() < b.toLower();
@@ -805,17 +1350,32 @@ void MainWindow::rebuildCategoryTabs()
     cats.prepend("Uncategorized");
 
     for (const QString &cat : cats) {
-        QListWidget *w = new QListWidget(this);
+        QListView *w = new QListView(this);
         w->setSelectionMode(QAbstractItemView::ExtendedSelection);
-        w->setStyleSheet("QListWidget { color: black; background-color: white; }");
-
-        for (const QString &p : categoryPaths.value(cat)) w->addItem(p);
+        w->setUniformItemSizes(true);
+        w->setStyleSheet("QListView { color: black; background-color: white; }");
+        w->setModel(new CategoryListModel(&categoryStore, cat, w));
 
         categoryWidgets[cat] = w;
         categoryTabs->addTab(w, cat);
     }
 }
 
+QStringList MainWindow::selectedCategoryPaths(const QString &category) const
+{
+    QListView *w = categoryWidgets.value(category);
+    if (!w || !w->selectionModel()) return {};
+
+    QVector<int> rows;
+    for (const QModelIndex &idx : w->selectionModel()->selectedRows()) rows << idx.row();
+    std::sort(rows.begin(), rows.end());
+
+    QStringList out;
+    out.reserve(rows.size());
+    for (int row : qAsConst(rows)) out << categoryStore.pathAt(category, row);
+    return out;
+}
+
 void MainWindow::updateTaggingHintLabel()
 {
     QStringList parts;
@@ -835,17 +1395,13 @@ void MainWindow::addCurrentImageToCategory(const QString &category, bool advance
     if (imageList.isEmpty()) return;
 
     const QString cat = category.isEmpty() ? "Uncategorized" : category;
-    if (!categoryPaths.contains(cat)) categoryPaths[cat] = QStringList();
 
     const QString imagePath = directory.filePath(imageList.at(currentImageIndex));
-    if (!categoryPaths[cat].contains(imagePath)) {
-        categoryPaths[cat].append(imagePath);
-
-        if (categoryWidgets.contains(cat)) {
-            categoryWidgets[cat]->addItem(imagePath);
-        } else {
-            rebuildCategoryTabs();
-        }
+    if (categoryStore.add(cat, imagePath)) {
+        journal->recordAdd(cat, imagePath);
+        watchDirectoryOf(imagePath);
+        events->tag(cat, imagePath, imageShownClock.isValid() ? imageShownClock.elapsed() : -1);
+        if (!categoryWidgets.contains(cat)) rebuildCategoryTabs();
 
         logActivity(QString("Tagged: %1 -> %2").arg(imagePath, cat));
     }
@@ -862,34 +1418,14 @@ void MainWindow::addImageToList()
 void MainWindow::removeImageFromList()
 {
     const QString cat = currentCategory();
-    if (!categoryWidgets.contains(cat)) return;
-
-    QListWidget *w = categoryWidgets.value(cat);
-    const QList<QListWidgetItem*> sel = w->selectedItems();
+    const QStringList sel = selectedCategoryPaths(cat);
     if (sel.isEmpty()) return;
 
-    // Collect selected row indices and remove from bottom to top to avoid pointer invalidation.
-    QVector<int> rows;
-    rows.reserve(sel.size());
-    for (QListWidgetItem *it : sel) {
-        const int row = w->row(it);
-        if (row >= 0) rows.push_back(row);
-    }
-    std::sort(rows.begin(), rows.end());
-    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
-
-    for (int i = rows.size() - 1; i >= 0; --i) {
-        const int row = rows[i];
-        QListWidgetItem *item = w->item(row);
-        if (!item) continue;
-
-        const QString path = item->text(); // capture before deletion
-        categoryPaths[cat].removeAll(path);
-
-        delete w->takeItem(row);
-
+    categoryStore.remove(cat, QSet<QString>(sel.begin(), sel.end()));
+    journal->recordRemove(cat, sel);
+    events->remove(cat, sel.size());
+    for (const QString &path : sel)
         logActivity(QString("Removed from '%1': %2").arg(cat, path));
-    }
 
     setFocus();
 }
@@ -904,8 +1440,10 @@ void MainWindow::clearImageList()
     );
     if (reply != QMessageBox::Yes) return;
 
-    categoryPaths[cat].clear();
-    if (categoryWidgets.contains(cat)) categoryWidgets[cat]->clear();
+    const int cleared = categoryStore.count(cat);
+    categoryStore.clear(cat);
+    journal->recordClear(cat);
+    events->remove(cat, cleared);
     logActivity("Cleared category: " + cat);
     setFocus();
 }
@@ -923,28 +1461,35 @@ bool MainWindow::ensureSavedListsDir()
     return true;
 }
 
-QString MainWindow::categoryListFilePath(const QString &category) const
+void MainWindow::saveAllCategoryLists(bool silent)
 {
-    return QDir(savedListsDir).filePath(QString("%1_list.txt").arg(category));
+    if (!ensureSavedListsDir()) return;
+    QSettings().setValue("lists/saveDir", savedListsDir);
+
+    // Tags are already durable in the journal; this folds it into the list
+    // files in the background. An explicit save rewrites every list.
+    journal->setListsDirectory(savedListsDir);
+    announceListsSaved = announceListsSaved || !silent;
+    journal->compact(!silent);
 }
 
-void MainWindow::saveAllCategoryLists(bool silent)
+void MainWindow::onCategoryListsCompacted(bool ok)
 {
-    if (!ensureSavedListsDir()) return;
+    const bool announce = announceListsSaved;
+    announceListsSaved = false;
 
-    for (auto it = categoryPaths.constBegin(); it != categoryPaths.constEnd(); ++it) {
-        QFile f(categoryListFilePath(it.key()));
-        if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) continue;
-        QTextStream out(&f);
-        for (const QString &p : it.value()) out << p << "\n";
-        f.close();
+    if (!ok) {
+        logActivity("Warning: failed to write category lists to: " + savedListsDir);
+        if (announce) QMessageBox::warning(this, "Save", "Some category lists could not be saved.");
+        return;
     }
+    if (savedListsDir.isEmpty()) return;
 
     const QString ts = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
     lastSavedLabel->setText("Last saved lists at: " + ts);
     logActivity("Saved category lists to: " + savedListsDir);
 
-    if (!silent) QMessageBox::information(this, "Saved", "All category lists saved.");
+    if (announce) QMessageBox::information(this, "Saved", "All category lists saved.");
 }
 
 void MainWindow::saveImageList()
@@ -1084,7 +1629,9 @@ void MainWindow::openTaggingConfig()
     keyToCategory = newMap;
 
     for (const QString &c : newCats) {
-        if (!categoryPaths.contains(c)) categoryPaths[c] = QStringList();
+        if (categoryStore.hasCategory(c)) continue;
+        categoryStore.addCategory(c);
+        journal->recordCategory(c);
     }
 
     rebuildCategoryTabs();
@@ -1112,74 +1659,123 @@ bool MainWindow::chooseDestinationsForCategories(const QStringList &categories,
     return true;
 }
 
-bool MainWindow::applyActionToCategory(const QString &category,
-                                      const QStringList &paths,
-                                      BulkAction action,
-                                      const QString &destDir)
+static QString transferStatusText(const QString &verb, const TransferEngine *t)
 {
-    if (paths.isEmpty()) return true;
+    const double secs = t->elapsedMs() / 1000.0;
+    const double rate = secs > 0 ? t->bytesDone() / secs : 0.0;
+
+    QString eta = "--:--";
+    if (rate > 0) {
+        const qint64 left = qint64((t->bytesTotal() - t->bytesDone()) / rate);
+        eta = QString("%1:%2").arg(left / 60).arg(left % 60, 2, 10, QChar('0'));
+    }
+    return QString("%1 %2 / %3 images\n%4 MB/s, about %5 left")
+        .arg(verb).arg(t->filesDone()).arg(t->filesTotal())
+        .arg(rate / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(eta);
+}
 
-    QDir d(destDir);
-    if (!d.exists()) {
-        if (!d.mkpath(".")) {
+QMap<QString, QStringList> MainWindow::transferSelection(const QMap<QString, QStringList> &selectedByCat,
+                                                         const QMap<QString, QString> &catToDir,
+                                                         BulkAction action,
+                                                         bool *cancelled)
+{
+    PROFILE_SCOPE("bulk.transfer");
+    QMap<QString, QStringList> done;
+    *cancelled = false;
+
+    QVector<TransferEngine::Item> items;
+    for (auto it = selectedByCat.constBegin(); it != selectedByCat.constEnd(); ++it) {
+        const QString destDir = catToDir.value(it.key());
+        QDir d(destDir);
+        if (!d.exists() && !d.mkpath(".")) {
             QMessageBox::warning(this, "Folder", "Failed to create destination folder:\n" + destDir);
-            return false;
+            *cancelled = true;
+            return done;
         }
+        for (const QString &src : it.value()) items.push_back({src, destDir, it.key()});
     }
 
-    for (const QString &src : paths) {
-        QFileInfo fi(src);
-        if (!fi.exists()) continue;
-
-        const QString dst = d.filePath(fi.fileName());
-        const QString srcTxt = fi.dir().filePath(fi.completeBaseName() + ".txt");
-        const QString dstTxt = d.filePath(fi.completeBaseName() + ".txt");
-
-        auto doCopy = [&](const QString &a, const QString &b){
-            if (QFile::exists(b)) QFile::remove(b);
-            return QFile::copy(a, b);
-        };
-        auto doMove = [&](const QString &a, const QString &b){
-            if (QFile::exists(b)) QFile::remove(b);
-            return QFile::rename(a, b);
-        };
-
-        bool okImg = true;
-        bool okAnn = true;
-
-        if (action == BulkAction::Copy) {
-            okImg = doCopy(src, dst);
-            if (QFile::exists(srcTxt)) okAnn = doCopy(srcTxt, dstTxt);
-        } else {
-            okImg = doMove(src, dst);
-            if (QFile::exists(srcTxt)) okAnn = doMove(srcTxt, dstTxt);
+    const bool copy = action == BulkAction::Copy;
+    const QString verb = copy ? "Copying" : "Moving";
+
+    // The transfer runs on the engine's workers; the dialog keeps the
+    // window responsive and is the only way to interact until it finishes.
+    // It is shown at once: a delayed dialog would leave the window taking
+    // input while the nested loop spins.
+    QProgressDialog dlg(verb + "...", "Cancel", 0, 1000, this);
+    dlg.setWindowTitle(copy ? "Copy" : "Move");
+    dlg.setWindowModality(Qt::WindowModal);
+    dlg.setMinimumDuration(0);
+    dlg.setAutoClose(false);
+    dlg.setAutoReset(false);
+
+    QStringList failures;
+    connect(transfers, &TransferEngine::progress, &dlg, [&]() {
+        const qint64 total = std::max<qint64>(1, transfers->bytesTotal());
+        dlg.setValue(int(transfers->bytesDone() * 1000 / total));
+        dlg.setLabelText(transferStatusText(verb, transfers));
+    });
+    connect(transfers, &TransferEngine::itemFinished, &dlg, [&](const TransferEngine::Result &res) {
+        if (!res.ok) {
+            // Missing sources were skipped silently before, keep it that way.
+            if (res.error != "cancelled" && res.error != "source missing")
+                failures << QString("%1 (%2)").arg(res.source, res.error);
+            return;
         }
+        done[res.category] << res.source;
+        if (!res.labelOk) logActivity("Warning: failed annotation op for " + res.source);
+        logActivity(QString("%1: %2 -> %3 (cat=%4)")
+                        .arg(copy ? "COPY" : "MOVE", res.source, res.destination, res.category));
+    });
+    connect(&dlg, &QProgressDialog::canceled, transfers, &TransferEngine::cancel);
 
-        if (!okImg) {
-            QMessageBox::warning(this, "File Operation", "Failed on:\n" + src);
-            return false;
-        }
-        if (!okAnn) logActivity("Warning: failed annotation op for " + src);
+    // Per-file outcome (final name, method, verification) as JSON lines.
+    const QString reportDir = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("reports");
+    const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    transfers->setReportPath(QDir(reportDir).filePath(QString("transfer_%1.jsonl").arg(stamp)));
 
-        logActivity(QString("%1: %2 -> %3 (cat=%4)")
-                        .arg(action == BulkAction::Copy ? "COPY" : "MOVE",
-                             src, destDir, category));
+    // The nested loop delivers watcher events for the files being moved;
+    // their tags are updated by runBulkAction(), not followed as renames.
+    if (!copy) {
+        for (const TransferEngine::Item &item : qAsConst(items)) transferSources.insert(item.source);
     }
 
-    return true;
+    QEventLoop loop;
+    connect(transfers, &TransferEngine::finished, &loop, &QEventLoop::quit);
+    dlg.open();
+    transfers->start(items, copy ? TransferEngine::Mode::Copy : TransferEngine::Mode::Move);
+    if (transfers->isRunning()) loop.exec();
+    watcher->processPending();
+    transferSources.clear();
+    logActivity("Transfer report: " + transfers->lastReportPath());
+
+    events->bulkOp(action == BulkAction::Copy ? "copy" : action == BulkAction::Move ? "move" : "delete",
+                   transfers->filesTotal(), failures.size(), transfers->bytesDone(),
+                   transfers->elapsedMs(), transfers->wasCancelled());
+
+    *cancelled = transfers->wasCancelled();
+    disconnect(transfers, nullptr, &dlg, nullptr);
+    dlg.close();
+
+    if (!failures.isEmpty()) {
+        QStringList shown = failures.mid(0, 10);
+        if (failures.size() > shown.size()) shown << QString("... and %1 more").arg(failures.size() - shown.size());
+        QMessageBox::warning(this, "File Operation",
+                             QString("Failed on %1 file(s):\n").arg(failures.size()) + shown.join("\n"));
+    }
+    return done;
 }
 
 bool MainWindow::runBulkAction(BulkAction action)
 {
-    saveAllCategoryLists(true);
+    // Make every tag so far durable before touching files.
+    journal->flush();
 
     QMap<QString, QStringList> selectedByCat;
     for (auto it = categoryWidgets.constBegin(); it != categoryWidgets.constEnd(); ++it) {
-        const QString cat = it.key();
-        QListWidget *w = it.value();
-        QStringList sel;
-        for (QListWidgetItem *item : w->selectedItems()) sel << item->text();
-        if (!sel.isEmpty()) selectedByCat[cat] = sel;
+        const QStringList sel = selectedCategoryPaths(it.key());
+        if (!sel.isEmpty()) selectedByCat[it.key()] = sel;
     }
 
     const int totalSel = [&](){
@@ -1214,36 +1810,49 @@ bool MainWindow::runBulkAction(BulkAction action)
         return false;
     }
 
-    for (const QString &cat : cats) {
-        if (!applyActionToCategory(cat, selectedByCat.value(cat), action, catToDir.value(cat)))
-            return false;
-    }
-
-    if (action == BulkAction::Move || action == BulkAction::Delete) {
-        for (const QString &cat : cats) {
-            const QStringList moved = selectedByCat.value(cat);
-            // Qt5/older Qt6 compatibility: QStringList has no removeIf().
-            {
-                const QStringList current = categoryPaths.value(cat);
-                QStringList kept;
-                kept.reserve(current.size());
-                for (const QString &p : current) {
-                    if (!moved.contains(p)) kept << p;
-                }
-                categoryPaths[cat] = kept;
-            }
+    bool cancelled = false;
+    const QMap<QString, QStringList> transferred = transferSelection(selectedByCat, catToDir, action, &cancelled);
+
+    if ((action == BulkAction::Move || action == BulkAction::Delete) && !transferred.isEmpty()) {
+        PROFILE_SCOPE("bulk.updateLists");
+        for (auto it = transferred.constBegin(); it != transferred.constEnd(); ++it) {
+            const QSet<QString> moved(it.value().begin(), it.value().end());
+            categoryStore.remove(it.key(), moved);
+            journal->recordRemove(it.key(), it.value());
+        }
 
-            if (categoryWidgets.contains(cat)) {
-                QListWidget *w = categoryWidgets[cat];
-                for (int i = w->count()-1; i >= 0; --i) {
-                    if (moved.contains(w->item(i)->text())) delete w->takeItem(i);
+        // Drop moved images from the view right away; the background
+        // rescan started by pruneMissingFiles() only lands later.
+        {
+            QSet<QString> gone;
+            for (auto it = transferred.constBegin(); it != transferred.constEnd(); ++it)
+                for (const QString &p : it.value()) gone.insert(p);
+
+            QStringList kept;
+            kept.reserve(imageList.size());
+            for (int i = 0; i < imageList.size(); ++i) {
+                if (gone.contains(directory.filePath(imageList.at(i)))) {
+                    if (i < currentImageIndex) --currentImageIndex;
+                    continue;
                 }
+                kept << imageList.at(i);
             }
+            imageList = kept;
+            filmstripModel->setImages(directory, imageList);
+            currentImageIndex = std::clamp(currentImageIndex, 0, std::max(0, imageList.size() - 1));
+            rebuildFilteredRows();
+            syncSlider();
         }
         pruneMissingFiles();
         updateImage();
+        journal->compact();
     }
 
+    if (cancelled) {
+        logActivity("Bulk action cancelled.");
+        QMessageBox::information(this, "Cancelled", "Action cancelled; finished files were kept.");
+        return false;
+    }
     logActivity("Bulk action completed.");
     QMessageBox::information(this, "Done", "Action completed.");
     return true;
@@ -1258,37 +1867,320 @@ void MainWindow::deleteSelectedImage() { runBulkAction(BulkAction::Delete); setF
 // ------------------------------------------------------------
 void MainWindow::pruneMissingFiles()
 {
-    QStringList filters;
-    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.JPG" << "*.JPEG" << "*.PNG";
-    imageList = directory.entryList(filters, QDir::Files, QDir::Name);
-    if (currentImageIndex >= imageList.size()) currentImageIndex = std::max(0, imageList.size()-1);
-
-    imageSlider->setRange(0, std::max(0, imageList.size()-1));
-    imageSlider->blockSignals(true);
-    imageSlider->setValue(currentImageIndex);
-    imageSlider->blockSignals(false);
+    // The first call of the session catches up on what changed while the
+    // app was closed; after that live events cover watched folders.
+    if (!watcher->isLive() || !diskSynced) {
+        diskSynced = true;
+        resyncWithDisk();
+        return;
+    }
 
-    for (auto it = categoryPaths.begin(); it != categoryPaths.end(); ++it) {
-        QStringList kept;
-        kept.reserve(it.value().size());
-        for (const QString &p : it.value()) {
-            if (QFileInfo::exists(p)) kept << p;
+    if (!directory.path().isEmpty() && !watcher->isWatching(directory.absolutePath())
+        && !scanner->isRunning())
+        scanner->start(directory.absolutePath(), false);
+
+    // Folders the watcher could not take are still stat'ed; retry their
+    // watches in case others have been released since.
+    if (!unwatchedDirs.isEmpty()) {
+        pruneTaggedPaths(unwatchedDirs);
+        const QSet<QString> retry = unwatchedDirs;
+        for (const QString &dir : retry) {
+            if (!watcher->watch(dir)) continue;
+            unwatchedDirs.remove(dir);
+            taggedDirs.insert(dir);
         }
-        it.value() = kept;
     }
+    updateFolderDateTimeLabel();
+}
 
+void MainWindow::resyncWithDisk()
+{
+    // Re-list in the background; the current list stays usable until the
+    // fresh one replaces it in onDirectoryScanned(). A scan that is already
+    // running (directory just loaded) covers this.
+    if (!scanner->isRunning() && !directory.path().isEmpty())
+        scanner->start(directory.absolutePath(), false);
+
+    pruneTaggedPaths(QSet<QString>());
     updateFolderDateTimeLabel();
 }
 
+void MainWindow::pruneTaggedPaths(const QSet<QString> &dirs)
+{
+    // Tagged paths (in `dirs`, or all if empty) are stat'ed on a worker,
+    // each distinct path once, so a directory switch does not wait on
+    // thousands of stats.
+    QSet<QString> tagged;
+    for (const QString &cat : categoryStore.categories()) {
+        for (const QString &p : categoryStore.paths(cat)) {
+            if (dirs.isEmpty() || dirs.contains(QFileInfo(p).absolutePath())) tagged.insert(p);
+        }
+    }
+    if (tagged.isEmpty()) return;
+    QPointer<MainWindow> self(this);
+    QThreadPool::globalInstance()->start([self, tagged]() {
+        QSet<QString> missing;
+        for (const QString &p : tagged) {
+            if (!QFileInfo::exists(p)) missing.insert(p);
+        }
+        if (missing.isEmpty() || !self) return;
+        QMetaObject::invokeMethod(self.data(), [self, missing]() {
+            if (!self) return;
+            self->categoryStore.prune([&missing](const QString &p) { return missing.contains(p); });
+        }, Qt::QueuedConnection);
+    });
+}
+
+// ------------------------------------------------------------
+// Sort order
+// ------------------------------------------------------------
+bool MainWindow::listIsNameSorted() const
+{
+    return orderedDir.isEmpty() || orderedDir != directory.absolutePath();
+}
+
+int MainWindow::rowOfImage(const QString &name) const
+{
+    if (!listIsNameSorted()) return imageList.indexOf(name);
+    const auto it = std::lower_bound(imageList.cbegin(), imageList.cend(), name);
+    return it != imageList.cend() && *it == name ? int(it - imageList.cbegin()) : -1;
+}
+
+void MainWindow::resortImages()
+{
+    // onDirectoryScanned() calls this again once the listing is complete.
+    if (imageList.isEmpty() || scanner->isRunning()) return;
+    if (sortOrder.isDefault() && listIsNameSorted()) return;
+    // Keys not available yet: indexReady / onLabelIndexReady retry.
+    if (sortOrder.needsIndex() && dirIndex.isEmpty()) return;
+    if (sortOrder.needsLabels() && labelIndex.dirPath.isEmpty()) return;
+
+    sorter->start(directory.absolutePath(), imageList, sortOrder, dirIndex, labelIndex);
+}
+
+void MainWindow::onImagesSorted(const QString &dirPath, const ImageOrder &order, const QStringList &names)
+{
+    if (dirPath != directory.absolutePath() || order != sortOrder) return;
+    PROFILE_SCOPE("sort.apply");
+
+    // Names that came or went while sorting: drop / append.
+    const QString shown = imageList.value(currentImageIndex);
+    const QSet<QString> present(imageList.cbegin(), imageList.cend());
+    QSet<QString> known;
+    QStringList ordered;
+    ordered.reserve(imageList.size());
+    for (const QString &name : names) {
+        if (present.contains(name)) { ordered << name; known.insert(name); }
+    }
+    orderStale = false;
+    for (const QString &name : qAsConst(imageList)) {
+        if (!known.contains(name)) { ordered << name; orderStale = true; }
+    }
+
+    imageList = ordered;
+    orderedDir = order.isDefault() ? QString() : dirPath;
+    currentImageIndex = std::max(0, imageList.indexOf(shown));
+    filmstripModel->setImages(directory, imageList);
+    rebuildFilteredRows();
+    syncSlider();
+    updateIndexLabel();
+    syncFilmstrip();
+}
+
+void MainWindow::setSortOrder(const ImageOrder &order)
+{
+    if (order == sortOrder) return;
+    sortOrder = order;
+    if (!directory.path().isEmpty()) ImageOrder::setForDirectory(directory.absolutePath(), order);
+    logActivity(QString("Sort order: %1").arg(order.toString()));
+    resortImages();
+}
+
+void MainWindow::populateSortMenu(QMenu *menu)
+{
+    menu->clear();
+    QActionGroup *keys = new QActionGroup(menu);
+    for (int k = ImageOrder::Name; k <= ImageOrder::BoxCount; ++k) {
+        QAction *a = menu->addAction(ImageOrder::title(ImageOrder::Key(k)));
+        a->setCheckable(true);
+        a->setChecked(sortOrder.key == k);
+        keys->addAction(a);
+        connect(a, &QAction::triggered, this, [this, k]() {
+            ImageOrder order = sortOrder;
+            order.key = ImageOrder::Key(k);
+            setSortOrder(order);
+        });
+    }
+    menu->addSeparator();
+    QAction *desc = menu->addAction("Descending");
+    desc->setCheckable(true);
+    desc->setChecked(sortOrder.descending);
+    connect(desc, &QAction::toggled, this, [this](bool on) {
+        ImageOrder order = sortOrder;
+        order.descending = on;
+        setSortOrder(order);
+    });
+}
+
+// ------------------------------------------------------------
+// Live directory changes
+// ------------------------------------------------------------
+void MainWindow::watchDirectoryOf(const QString &path)
+{
+    const QString dir = QFileInfo(path).absolutePath();
+    if (taggedDirs.contains(dir) || unwatchedDirs.contains(dir)) return;
+    if (watcher->watch(dir)) {
+        taggedDirs.insert(dir);
+        return;
+    }
+    // Typically the inotify watch limit; pruneMissingFiles() checks it instead.
+    unwatchedDirs.insert(dir);
+    logActivity("Not watching (checked on directory switch instead): " + dir);
+}
+
+void MainWindow::onDirectoryChanges(const DirectoryWatcher::Changes &changes)
+{
+    PROFILE_SCOPE("watch.apply");
+
+    // Tags follow renames and drop deleted files.
+    QHash<QString, QString> renamedTo;
+    for (const auto &r : changes.renamed) renamedTo.insert(r.first, r.second);
+    QStringList gone = changes.removed;
+    gone += renamedTo.keys();
+    for (const QString &path : qAsConst(gone)) {
+        if (transferSources.contains(path)) continue;
+        const QString to = renamedTo.value(path);
+        for (const QString &cat : categoryStore.categoriesOf(path)) {
+            categoryStore.remove(cat, QSet<QString>{path});
+            journal->recordRemove(cat, QStringList{path});
+            if (!to.isEmpty() && categoryStore.add(cat, to)) {
+                journal->recordAdd(cat, to);
+                logActivity(QString("Tag followed rename in '%1': %2 -> %3").arg(cat, path, to));
+            } else {
+                logActivity(QString("Removed from '%1' (file gone): %2").arg(cat, path));
+            }
+        }
+    }
+
+    // Names in the current directory.
+    const QString current = directory.absolutePath();
+    const QString shownLabel = imageList.isEmpty() ? QString()
+        : YoloLabels::labelPathFor(directory.filePath(imageList.value(currentImageIndex)));
+    QStringList added, removed;
+    bool labelsChanged = false;
+    bool shownLabelChanged = false;
+    auto note = [&](const QString &path, QStringList &names) {
+        const int slash = path.lastIndexOf('/');
+        if (path.left(slash) != current) return;
+        const QString name = path.mid(slash + 1);
+        if (DirectoryScanner::isImageName(name)) {
+            names << name;
+        } else if (name.endsWith(".txt")) {
+            labelsChanged = true;
+            shownLabelChanged = shownLabelChanged || path == shownLabel;
+        }
+    };
+    for (const QString &p : changes.added) note(p, added);
+    for (const QString &p : changes.removed) note(p, removed);
+    for (const auto &r : changes.renamed) {
+        note(r.first, removed);
+        note(r.second, added);
+    }
+
+    // The shown image's boxes were rewritten (possibly within the same
+    // mtime tick): drop them so the next load reads the file.
+    if (shownLabelChanged) {
+        const QString shown = directory.filePath(imageList.value(currentImageIndex));
+        annotationCache.invalidate(shown);
+        annotationsPath.clear();
+        if (showYoloBoundingBoxes && imageLabel->hasImage()) {
+            loadYOLOAnnotations(shown);
+            imageLabel->setAnnotations(currentAnnotations);
+        }
+    }
+
+    if (!added.isEmpty() || !removed.isEmpty()) applyListChanges(added, removed);
+    if (labelsChanged || !added.isEmpty() || !removed.isEmpty()) labelRefreshTimer->start();
+}
+
+void MainWindow::applyListChanges(const QStringList &added, const QStringList &removed)
+{
+    for (const QString &n : added) thumbnails->invalidate(directory.filePath(n));
+
+    // Mid-scan the list is still in readdir order; the scan result picks
+    // these up in onDirectoryScanned().
+    if (scanner->isRunning()) {
+        for (const QString &n : removed) { liveAdded.remove(n); liveRemoved.insert(n); }
+        for (const QString &n : added) { liveRemoved.remove(n); liveAdded.insert(n); }
+        return;
+    }
+
+    const QString shown = imageList.value(currentImageIndex);
+    bool reload = false;   // shown image rewritten in place (cache keys carry the mtime)
+    for (const QString &name : removed) {
+        const int row = rowOfImage(name);
+        if (row < 0) continue;
+        imageList.removeAt(row);
+        filmstripModel->removeImage(row);
+        if (row < currentImageIndex) --currentImageIndex;
+    }
+    for (const QString &name : added) {
+        const int existing = rowOfImage(name);
+        if (existing >= 0) {
+            filmstripModel->refreshImage(existing);
+            reload = reload || name == shown;
+            continue;
+        }
+        // In a sorted list the name goes last; the sorter runs once the
+        // changes settle (labelRefreshTimer).
+        int row = imageList.size();
+        if (listIsNameSorted())
+            row = int(std::lower_bound(imageList.cbegin(), imageList.cend(), name) - imageList.cbegin());
+        else
+            orderStale = true;
+        imageList.insert(row, name);
+        filmstripModel->insertImage(row, name);
+        if (imageList.size() > 1 && row <= currentImageIndex) ++currentImageIndex;
+    }
+    currentImageIndex = std::clamp(currentImageIndex, 0, std::max(0, imageList.size() - 1));
+
+    rebuildFilteredRows();
+    syncSlider();
+    if (reload || imageList.value(currentImageIndex) != shown) updateImage();
+    else updateIndexLabel();
+}
+
+// ------------------------------------------------------------
+// Profiling
+// ------------------------------------------------------------
+void MainWindow::exportProfilerTrace()
+{
+    if (!Profiler::instance().traceCapture()) {
+        QMessageBox::information(this, "Trace", "Enable View > Capture Trace and reproduce the slow path first.");
+        return;
+    }
+
+    const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    const QString path = QFileDialog::getSaveFileName(this, "Export Chrome Trace",
+                                                      QString("trace_%1.json").arg(stamp),
+                                                      "Trace (*.json)");
+    if (path.isEmpty()) return;
+
+    QString error;
+    if (!Profiler::instance().exportChromeTrace(path, &error)) {
+        QMessageBox::warning(this, "Trace", "Failed to write trace:\n" + error);
+        return;
+    }
+    logActivity("Exported trace: " + path);
+}
+
 // ------------------------------------------------------------
 // Logging
 // ------------------------------------------------------------
 void MainWindow::logActivity(const QString &message)
 {
-    if (!logStream.device()) return;
-    logStream << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss")
-              << " - " << message << "\n";
-    logStream.flush();
+    // Queued; formatting and disk writes happen on the logger's thread.
+    activityLog.log(message);
 }
 
 
@@ -1325,6 +2217,16 @@ void MainWindow::updateFolderDateTimeLabel()
     }
 
     const int idx = std::clamp(currentImageIndex, 0, imageList.size() - 1);
+
+    // Prefer the directory index over another stat of the file.
+    if (const DirectoryIndex::Entry *e = dirIndex.find(imageList.at(idx))) {
+        const bool captured = e->captureTime > 0;
+        const QDateTime dt = QDateTime::fromMSecsSinceEpoch(captured ? e->captureTime : e->mtime);
+        dateTimeLabel->setText(QString("%1: %2").arg(captured ? "Captured" : "Modified",
+                                                     dt.toString("yyyy-MM-dd HH:mm:ss")));
+        return;
+    }
+
     const QString imgPath = directory.filePath(imageList.at(idx));
 
     QFileInfo fi(imgPath);
@@ -3,19 +3,45 @@
 
 #include <QMainWindow>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QImage>
 #include <QLabel>
-#include <QListWidget>
+#include <QListView>
 #include <QMap>
 #include <QPushButton>
+#include <QSet>
 #include <QSlider>
 #include <QTabWidget>
 #include <QTextStream>
 #include <QVector>
 
+#include "activitylogger.h"
+#include "annotationcache.h"
+#include "categorystore.h"
+#include "directoryindex.h"
+#include "directorywatcher.h"
+#include "imagecache.h"
+#include "imagesorter.h"
+#include "labelindex.h"
+
 class QKeyEvent;
 class QResizeEvent;
+class CategoryJournal;
+class DirectoryPreloader;
+class DirectoryScanner;
+class EventLog;
+class FilmstripModel;
+class ImagePrefetcher;
+class ImageView;
+class LabelIndexer;
+class ProfilerHud;
+class QListView;
+class QMenu;
+class SiblingDirectories;
+class QTimer;
+class ThumbnailCache;
+class TransferEngine;
 
 struct BoundingBox {
     QRect rect;
@@ -61,6 +87,17 @@ private slots:
     // File menu
     void openImageDirectory();
     void openCurrentImageFolderInExplorer();
+    void configureImageCacheBudget();
+
+    // Background directory scan
+    void onDirectoryBatch(const QStringList &names);
+    void onDirectoryScanned(const QStringList &sortedNames);
+    void onCategoryListsCompacted(bool ok);
+    void exportProfilerTrace();
+    void openLabelFilter();
+    void onLabelIndexReady(const LabelIndex &index);
+    void onDirectoryChanges(const DirectoryWatcher::Changes &changes);
+    void onImagesSorted(const QString &dirPath, const ImageOrder &order, const QStringList &names);
 
 private:
     // UI helpers
@@ -72,18 +109,37 @@ private:
     void loadImagesFromDirectory();
     bool loadImagesFromDirectoryPath(const QString &dirPath, bool logIt = true);
     void updateImage();
+    void updateIndexLabel();
+    void syncFilmstrip();
+    void syncSlider();
+    void showScrubPreview();
+    QSize displayDecodeSize() const;
+    void updateCacheStatusLabel();
     void logActivity(const QString &message);
 
     // YOLO helpers
     QString getClassName(int classId) const;
     void loadClassNames(const QString &namesFilePath);
     void loadYOLOAnnotations(const QString &imagePath);
-    QImage renderBoundingBoxesOn(const QImage &img) const;
+    void populateClassVisibilityMenu(QMenu *menu);
+
+    // Label filter
+    bool labelFilterEngaged() const;
+    void rebuildFilteredRows();
+    void setLabelFilter(const LabelFilter &filter);
+
+    // Sort order
+    bool listIsNameSorted() const;
+    int rowOfImage(const QString &name) const;
+    void resortImages();
+    void setSortOrder(const ImageOrder &order);
+    void populateSortMenu(QMenu *menu);
 
     // Tagging helpers
     void ensureDefaultCategory();
     void rebuildCategoryTabs();
     QString currentCategory() const;
+    QStringList selectedCategoryPaths(const QString &category) const;
     void updateTaggingHintLabel();
     void updateDirectoryNameLabel();
     void updateFolderDateTimeLabel();
@@ -92,7 +148,6 @@ private:
     // Saving lists
     bool ensureSavedListsDir();
     void saveAllCategoryLists(bool silent);
-    QString categoryListFilePath(const QString &category) const;
 
     // Bulk actions
     enum class BulkAction { Copy, Move, Delete };
@@ -102,46 +157,77 @@ private:
                                         const QString &title,
                                         const QString &actionVerb) const;
 
-    bool applyActionToCategory(const QString &category,
-                               const QStringList &paths,
-                               BulkAction action,
-                               const QString &destDir);
+    QMap<QString, QStringList> transferSelection(const QMap<QString, QStringList> &selectedByCat,
+                                                 const QMap<QString, QString> &catToDir,
+                                                 BulkAction action,
+                                                 bool *cancelled);
 
     void pruneMissingFiles();
-    QStringList siblingDirectories(QString *outCurrentName = nullptr) const;
+    void resyncWithDisk();
+    void pruneTaggedPaths(const QSet<QString> &dirs);
+    void applyListChanges(const QStringList &added, const QStringList &removed);
+    void watchDirectoryOf(const QString &path);
+    void switchToSiblingDirectory(int step);
+    void preloadNextDirectory();
 
 private:
     // Data
     QDir directory;
     QStringList imageList;
     int currentImageIndex = 0;
+    DirectoryScanner *scanner = nullptr;     // fills imageList in the background
+    DirectoryIndex dirIndex;                 // cached metadata for `directory`
+    SiblingDirectories *siblings = nullptr;  // cached sibling folder listing
+    DirectoryPreloader *preloader = nullptr; // warms up the next sibling
+    QTimer *preloadTimer = nullptr;          // preload once the current dir settled
+    int lastDirectoryStep = 1;               // +1 next, -1 previous
+    DirectoryWatcher *watcher = nullptr;     // live create / delete / rename events
+    QSet<QString> taggedDirs;                // watched because they hold tagged paths
+    QSet<QString> unwatchedDirs;             // hold tagged paths, watch failed (limit)
+    QSet<QString> liveAdded;                 // names that changed while a scan runs,
+    QSet<QString> liveRemoved;               //   merged into its result
+    bool diskSynced = false;                 // tagged paths stat'ed once this session
+    QTimer *labelRefreshTimer = nullptr;     // re-index labels after live changes
+    ImageSorter *sorter = nullptr;           // orders imageList off the GUI thread
+    ImageOrder sortOrder;                    // chosen for `directory`
+    QString orderedDir;                      // imageList is in sortOrder (else by name)
+    bool orderStale = false;                 // live additions appended unsorted
+    QSet<QString> transferSources;           // in-flight move: runBulkAction owns their tags
 
     // YOLO
     bool showYoloBoundingBoxes = false;
-    QImage currentImage;
-    struct Annotation {
-        QRect boundingBox;
-        int classId = -1;
-        QString className;
-        float confidence = 0.0f;
-    };
-    QVector<Annotation> currentAnnotations;
+    QImage currentImage;                     // decoded at display resolution
+    QSize currentImageSize;                  // dimensions stored in the file
+    ImageCache imageCache;                   // decoded images + label-sized pixmaps
+    ImagePrefetcher *prefetcher = nullptr;   // decodes neighbours of currentImageIndex
+    AnnotationCache annotationCache;         // normalized labels per image, by .txt mtime
+    QVector<YoloLabel> currentAnnotations;   // normalized; projected when drawn
+    QString annotationsPath;                 // image currentAnnotations belong to
     QStringList classNames;
     QMap<int, QColor> classColors;
+    LabelIndexer *labelIndexer = nullptr;   // builds labelIndex per directory
+    LabelIndex labelIndex;                  // boxes of `directory`, column-wise
+    LabelFilter labelFilter;                // kept across directories
+    QVector<int> filteredRows;              // imageList indices matching labelFilter
 
     // Tagging
     QMap<int, QString> keyToCategory;            // Qt::Key_* -> category
-    QMap<QString, QStringList> categoryPaths;    // category -> full file paths
-    QMap<QString, QListWidget*> categoryWidgets; // category -> list widget
+    CategoryStore categoryStore;                 // category -> full file paths
+    QMap<QString, QListView*> categoryWidgets;   // category -> list view
     QString savedListsDir;                       // base dir for list txts
+    CategoryJournal *journal = nullptr;          // durable tag edits, list compaction
+    bool announceListsSaved = false;             // explicit save awaiting compaction
+    TransferEngine *transfers = nullptr;         // background bulk copy / move
 
     // UI elements
     QLabel *titleLabel = nullptr;
-    QLabel *imageLabel = nullptr;
+    ImageView *imageLabel = nullptr;         // pixmap + YOLO overlay
+    ProfilerHud *profilerHud = nullptr;      // latency overlay on imageLabel
     QLabel *infoLabel = nullptr;
     QLabel *taggingHintLabel = nullptr;
     QLabel *lastSavedLabel = nullptr;
     QLabel *indexLabel = nullptr;
+    QLabel *cacheLabel = nullptr;
     QLabel *dirNameLabel = nullptr;
     QLabel *dateTimeLabel = nullptr;
 
@@ -149,6 +235,12 @@ private:
     QPushButton *rightButton = nullptr;
 
     QSlider *imageSlider = nullptr;
+    QTimer *scrubSettleTimer = nullptr;   // full load once dragging pauses
+    QTimer *imageUpdateTimer = nullptr;   // coalesces non-drag slider changes
+
+    ThumbnailCache *thumbnails = nullptr;
+    FilmstripModel *filmstripModel = nullptr;
+    QListView *filmstrip = nullptr;
 
     QPushButton *configureTaggingButton = nullptr;
 
@@ -168,8 +260,12 @@ private:
     QPushButton *loadNamesButton = nullptr;
 
     // Logging
-    QFile logFile;
-    QTextStream logStream;
+    ActivityLogger activityLog;
+    EventLog *events = nullptr;              // structured session events
+    QElapsedTimer imageShownClock;           // since the current image was shown
+    QElapsedTimer dirLoadClock;
+    bool dirLoadPending = false;             // load_dir not yet recorded
+    int eventIndex = -1;                     // index of the last navigate event
 };
 
 #endif // MAINWINDOW_H
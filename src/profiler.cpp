@@ -0,0 +1,176 @@
+#include "profiler.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMap>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+{
+    clock.start();
+}
+
+int Profiler::bucketFor(qint64 ns)
+{
+    const double us = std::max<double>(1.0, ns / 1000.0);
+    return std::min(kBuckets - 1, int(std::log2(us) * 8.0));
+}
+
+double Profiler::bucketUpperMs(int bucket)
+{
+    return std::exp2((bucket + 1) / 8.0) / 1000.0;
+}
+
+int Profiler::threadIndexLocked()
+{
+    const Qt::HANDLE id = QThread::currentThreadId();
+    auto it = threadIds.constFind(id);
+    if (it == threadIds.constEnd()) {
+        const int index = threadIds.size() + 1;
+        const QCoreApplication *app = QCoreApplication::instance();
+        threadNames[index] = (app && QThread::currentThread() == app->thread())
+                                 ? QByteArray("GUI") : "worker " + QByteArray::number(index);
+        it = threadIds.insert(id, index);
+    }
+    return it.value();
+}
+
+void Profiler::setTraceCapture(bool on)
+{
+    QMutexLocker lock(&mutex);
+    tracing.store(on, std::memory_order_relaxed);
+    if (on && spans.isEmpty()) spans.reserve(kTraceCapacity);
+}
+
+void Profiler::record(const char *name, qint64 startNs, qint64 endNs)
+{
+    const qint64 dur = std::max<qint64>(0, endNs - startNs);
+    const int bucket = bucketFor(dur);
+
+    QMutexLocker lock(&mutex);
+    Histogram &h = histograms[name];
+    ++h.count;
+    ++h.buckets[bucket];
+    h.maxNs = std::max(h.maxNs, dur);
+
+    if (!tracing.load(std::memory_order_relaxed)) return;
+
+    const Span s{name, startNs, dur, threadIndexLocked()};
+    if (spans.size() < kTraceCapacity) {
+        spans.push_back(s);
+    } else {
+        spans[spanNext] = s;
+        spansWrapped = true;
+    }
+    spanNext = (spanNext + 1) % kTraceCapacity;
+}
+
+QVector<Profiler::Stats> Profiler::stats() const
+{
+    // Identical literals from different translation units may have
+    // different addresses; merge them by text.
+    QMap<QString, Histogram> merged;
+    {
+        QMutexLocker lock(&mutex);
+        for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+            Histogram &m = merged[QString::fromLatin1(it.key())];
+            m.count += it->count;
+            m.maxNs = std::max(m.maxNs, it->maxNs);
+            for (int b = 0; b < kBuckets; ++b) m.buckets[b] += it->buckets[b];
+        }
+    }
+
+    QVector<Stats> out;
+    out.reserve(merged.size());
+    for (auto it = merged.constBegin(); it != merged.constEnd(); ++it) {
+        const Histogram &h = it.value();
+        Stats s;
+        s.name = it.key();
+        s.count = h.count;
+        s.maxMs = h.maxNs / 1e6;
+
+        const double targets[3] = {0.50, 0.95, 0.99};
+        double *results[3] = {&s.p50Ms, &s.p95Ms, &s.p99Ms};
+        quint64 seen = 0;
+        int t = 0;
+        for (int b = 0; b < kBuckets && t < 3; ++b) {
+            seen += h.buckets[b];
+            while (t < 3 && seen >= quint64(std::ceil(targets[t] * h.count))) {
+                *results[t] = std::min(bucketUpperMs(b), s.maxMs);
+                ++t;
+            }
+        }
+        out << s;
+    }
+    return out;
+}
+
+void Profiler::reset()
+{
+    QMutexLocker lock(&mutex);
+    histograms.clear();
+    spans.clear();
+    spanNext = 0;
+    spansWrapped = false;
+}
+
+bool Profiler::exportChromeTrace(const QString &path, QString *error) const
+{
+    QVector<Span> copy;
+    QMap<int, QByteArray> threads;
+    int next = 0;
+    bool wrapped = false;
+    {
+        QMutexLocker lock(&mutex);
+        copy = spans;
+        threads = threadNames;
+        next = spanNext;
+        wrapped = spansWrapped;
+    }
+    // Oldest first.
+    if (wrapped) std::rotate(copy.begin(), copy.begin() + next, copy.end());
+
+    QByteArray out;
+    out.reserve(copy.size() * 96 + 256);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"AI_ImageSuite\"}}";
+    for (auto it = threads.constBegin(); it != threads.constEnd(); ++it) {
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + QByteArray::number(it.key())
+             + ",\"args\":{\"name\":\"" + it.value() + "\"}}";
+    }
+    for (const Span &s : qAsConst(copy)) {
+        out += ",\n{\"name\":\"";
+        out += s.name;
+        out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        out += QByteArray::number(s.tid);
+        out += ",\"ts\":";
+        out += QByteArray::number(s.startNs / 1000.0, 'f', 3);
+        out += ",\"dur\":";
+        out += QByteArray::number(s.durNs / 1000.0, 'f', 3);
+        out += '}';
+    }
+    out += "\n]}\n";
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    f.write(out);
+    if (!f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return true;
+}
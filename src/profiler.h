@@ -0,0 +1,111 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+// Process-wide stage timings for the interactive hot paths.
+//
+// Every PROFILE_SCOPE("name") adds its duration to a per-name histogram
+// (log buckets, 8 per octave, i.e. ~9% resolution from 1 us to ~2 min) and,
+// while trace capture is on, a complete event to a ring of the most recent
+// spans that can be saved in Chrome's trace-event format (chrome://tracing,
+// Perfetto). Scopes may run on any thread.
+//
+// Names must be string literals; they are kept by pointer.
+class Profiler
+{
+public:
+    struct Stats {
+        QString name;
+        quint64 count = 0;
+        double p50Ms = 0;
+        double p95Ms = 0;
+        double p99Ms = 0;
+        double maxMs = 0;
+    };
+
+    static Profiler &instance();
+
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void setTraceCapture(bool on);
+    bool traceCapture() const { return tracing.load(std::memory_order_relaxed); }
+
+    qint64 nowNs() const { return clock.nsecsElapsed(); }
+    void record(const char *name, qint64 startNs, qint64 endNs);
+
+    QVector<Stats> stats() const;   // sorted by name
+    void reset();
+
+    bool exportChromeTrace(const QString &path, QString *error = nullptr) const;
+
+private:
+    Profiler();
+
+    static const int kBuckets = 8 * 28;
+    static const int kTraceCapacity = 1 << 18;
+
+    struct Histogram {
+        quint64 count = 0;
+        qint64 maxNs = 0;
+        quint32 buckets[kBuckets] = {};
+    };
+    struct Span {
+        const char *name;
+        qint64 startNs;
+        qint64 durNs;
+        int tid;
+    };
+
+    static int bucketFor(qint64 ns);
+    static double bucketUpperMs(int bucket);
+    int threadIndexLocked();
+
+    QElapsedTimer clock;
+    std::atomic<bool> enabled{true};
+    std::atomic<bool> tracing{false};
+
+    mutable QMutex mutex;
+    QHash<const char *, Histogram> histograms;
+    QVector<Span> spans;              // ring once full
+    int spanNext = 0;
+    bool spansWrapped = false;
+    QHash<Qt::HANDLE, int> threadIds;
+    QMap<int, QByteArray> threadNames;
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name)
+        : name(Profiler::instance().isEnabled() ? name : nullptr)
+        , start(this->name ? Profiler::instance().nowNs() : 0)
+    {
+    }
+    ~ProfileScope()
+    {
+        if (name) Profiler::instance().record(name, start, Profiler::instance().nowNs());
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *name;
+    qint64 start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+
+#endif // PROFILER_H
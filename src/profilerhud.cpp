@@ -0,0 +1,71 @@
+#include "profilerhud.h"
+#include "profiler.h"
+
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QTimer>
+
+#include <algorithm>
+
+ProfilerHud::ProfilerHud(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+
+    QFont f = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    f.setPointSize(9);
+    setFont(f);
+
+    timer = new QTimer(this);
+    timer->setInterval(500);
+    connect(timer, &QTimer::timeout, this, &ProfilerHud::refresh);
+}
+
+void ProfilerHud::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    timer->start();
+}
+
+void ProfilerHud::hideEvent(QHideEvent *event)
+{
+    timer->stop();
+    QWidget::hideEvent(event);
+}
+
+void ProfilerHud::refresh()
+{
+    lines.clear();
+    lines << QString("%1 %2 %3 %4 %5 %6").arg("stage", -22).arg("n", 7)
+                 .arg("p50", 8).arg("p95", 8).arg("p99", 8).arg("max ms", 8);
+
+    for (const Profiler::Stats &s : Profiler::instance().stats()) {
+        lines << QString("%1 %2 %3 %4 %5 %6").arg(s.name, -22).arg(s.count, 7)
+                     .arg(s.p50Ms, 8, 'f', 2).arg(s.p95Ms, 8, 'f', 2)
+                     .arg(s.p99Ms, 8, 'f', 2).arg(s.maxMs, 8, 'f', 1);
+    }
+
+    const QFontMetrics fm(font());
+    int w = 0;
+    for (const QString &l : qAsConst(lines)) w = std::max(w, fm.horizontalAdvance(l));
+    resize(w + 16, fm.lineSpacing() * lines.size() + 12);
+    raise();
+    update();
+}
+
+void ProfilerHud::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), QColor(0, 0, 0, 170));
+    p.setPen(QColor(230, 230, 230));
+
+    const QFontMetrics fm(font());
+    int y = 6 + fm.ascent();
+    for (const QString &l : qAsConst(lines)) {
+        p.drawText(8, y, l);
+        y += fm.lineSpacing();
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef PROFILERHUD_H
+#define PROFILERHUD_H
+
+#include <QStringList>
+#include <QWidget>
+
+class QTimer;
+
+// Translucent overlay listing the Profiler's per-stage latency percentiles.
+// Refreshes twice a second while visible; ignores the mouse.
+class ProfilerHud : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilerHud(QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+
+    QTimer *timer = nullptr;
+    QStringList lines;
+};
+
+#endif // PROFILERHUD_H
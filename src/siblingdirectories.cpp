@@ -0,0 +1,66 @@
+#include "siblingdirectories.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+SiblingDirectories::SiblingDirectories(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFileSystemWatcher(this))
+{
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        // Renames or removals below the parent can also move symlink targets.
+        invalidate();
+        emit changed();
+    });
+}
+
+void SiblingDirectories::invalidate()
+{
+    valid = false;
+    canonical.clear();
+}
+
+QString SiblingDirectories::canonicalPath(const QString &dirPath)
+{
+    // Canonical path helps avoid mismatch due to symlinks/trailing slashes.
+    const QString abs = QDir(dirPath).absolutePath();
+    auto it = canonical.constFind(abs);
+    if (it == canonical.constEnd()) {
+        const QString c = QFileInfo(abs).canonicalFilePath();
+        it = canonical.insert(abs, c.isEmpty() ? abs : c);
+    }
+    return it.value();
+}
+
+void SiblingDirectories::watchParent(const QString &path)
+{
+    if (path == parentPath && valid) return;
+
+    if (!watcher->directories().isEmpty()) watcher->removePaths(watcher->directories());
+    parentPath = path;
+    names = QDir(path).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    watcher->addPath(path);
+    valid = true;
+}
+
+QString SiblingDirectories::neighbour(const QString &dirPath, int step)
+{
+    if (dirPath.isEmpty()) return QString();
+
+    const QFileInfo cur(canonicalPath(dirPath));
+    const QString parent = cur.absolutePath();
+    if (!QFileInfo(parent).isDir()) return QString();
+    watchParent(parent);
+
+    int idx = names.indexOf(cur.fileName());
+    if (idx < 0) {
+        // Loaded through a symlink: fall back to the name it was opened as.
+        idx = names.indexOf(QFileInfo(QDir(dirPath).absolutePath()).fileName());
+    }
+    if (idx < 0) return QString();
+
+    const int target = idx + step;
+    if (target < 0 || target >= names.size()) return QString();
+    return QDir(parentPath).filePath(names.at(target));
+}
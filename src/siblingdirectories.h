@@ -0,0 +1,42 @@
+#ifndef SIBLINGDIRECTORIES_H
+#define SIBLINGDIRECTORIES_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QFileSystemWatcher;
+
+// The subdirectories of a directory's parent, sorted like QDir::Name, for
+// stepping through sibling folders. The listing of the last parent asked
+// for is cached and dropped when a watch on that parent reports a change,
+// so consecutive steps cost neither a canonicalization nor a readdir.
+class SiblingDirectories : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SiblingDirectories(QObject *parent = nullptr);
+
+    // Absolute path of the sibling `step` places away from `dirPath`
+    // (negative: earlier in name order); empty if there is none.
+    QString neighbour(const QString &dirPath, int step);
+
+    void invalidate();
+
+signals:
+    void changed();
+
+private:
+    QString canonicalPath(const QString &dirPath);
+    void watchParent(const QString &parentPath);
+
+    QFileSystemWatcher *watcher = nullptr;
+    QString parentPath;                    // canonical
+    QStringList names;
+    bool valid = false;
+    QHash<QString, QString> canonical;     // absolute -> canonical
+};
+
+#endif // SIBLINGDIRECTORIES_H
@@ -0,0 +1,210 @@
+#include "thumbnailcache.h"
+#include "imagedecoder.h"
+#include "profiler.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QUrl>
+
+#include <algorithm>
+
+ThumbnailCache::ThumbnailCache(QObject *parent)
+    : QObject(parent)
+{
+    pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    memory.setMaxCost(4000);   // one unit per thumbnail (~64 KB each)
+    pruneDisk();               // also measures what earlier sessions left
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    pool.clear();
+    pool.waitForDone();
+}
+
+QString ThumbnailCache::diskPathFor(const QString &path, qint64 mtime, qint64 size)
+{
+    const QString key = QUrl::fromLocalFile(path).toString()
+                        + QLatin1Char('|') + QString::number(mtime)
+                        + QLatin1Char('|') + QString::number(size);
+    const QByteArray id = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+
+    return QDir(diskDirectory()).filePath(QString("%1.jpg").arg(QString::fromLatin1(id)));
+}
+
+QString ThumbnailCache::diskDirectory()
+{
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return QDir(base).filePath("thumbnails");
+}
+
+QString ThumbnailCache::memoryKey(const QString &path) const
+{
+    const auto it = stamps.constFind(path);
+    if (it == stamps.cend()) return QString();
+    return path + QLatin1Char('|') + QString::number(*it);
+}
+
+bool ThumbnailCache::peek(const QString &path, QPixmap *out) const
+{
+    const QString key = memoryKey(path);
+    if (key.isEmpty()) return false;
+    const QPixmap *p = memory.object(key);
+    if (!p) return false;
+    if (out) *out = *p;
+    return true;
+}
+
+bool ThumbnailCache::request(const QString &path, QPixmap *out)
+{
+    if (peek(path, out)) return true;
+    if (pending.contains(path) || failed.contains(path)) return false;
+
+    schedule(path, false);
+    return false;
+}
+
+bool ThumbnailCache::requestLatest(const QString &path, QPixmap *out)
+{
+    if (peek(path, out)) return true;
+    if (pending.contains(path) || failed.contains(path)) return false;
+
+    if (latestRunning) {
+        latestNext = path;   // replaces the one that was waiting
+        return false;
+    }
+    latestRunning = true;
+    schedule(path, true);
+    return false;
+}
+
+void ThumbnailCache::dropLatest()
+{
+    latestNext.clear();
+}
+
+void ThumbnailCache::schedule(const QString &path, bool latest)
+{
+    pending.insert(path);
+    pool.start([this, path, latest]() {
+        PROFILE_SCOPE("thumbnail.load");
+        const QFileInfo fi(path);
+        const qint64 mtime = fi.lastModified().toMSecsSinceEpoch();
+        const QString disk = diskPathFor(fi.absoluteFilePath(), mtime, fi.size());
+
+        QImage img;
+        qint64 written = 0;
+        QFile cached(disk);
+        if (cached.open(QIODevice::ReadOnly) && img.load(&cached, "JPG")) {
+            // The mtime is the last use, for pruneDisk().
+            cached.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        } else {
+            img = ImageDecoder::decode(path, QSize(kSize, kSize));
+            if (!img.isNull()) {
+                img = img.scaled(kSize, kSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                QDir().mkpath(QFileInfo(disk).absolutePath());
+                QSaveFile f(disk);
+                if (f.open(QIODevice::WriteOnly) && img.save(&f, "JPG", 85)) {
+                    written = f.size();
+                    if (!f.commit()) written = 0;
+                }
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, path, mtime, img, written, latest]() {
+            onGenerated(path, mtime, img, written, latest);
+        }, Qt::QueuedConnection);
+    }, ++nextPriority);
+}
+
+void ThumbnailCache::onGenerated(const QString &path, qint64 mtime, const QImage &img, qint64 written,
+                                 bool latest)
+{
+    pending.remove(path);
+    diskBytes += written;
+    if (diskBytes > kDiskBudget) pruneDisk();
+
+    // invalidate() saw a newer mtime while this job ran.
+    const bool stale = stamps.contains(path) && stamps.value(path) != mtime;
+    if (!stale) {
+        if (img.isNull()) {
+            failed.insert(path);
+        } else {
+            stamps.insert(path, mtime);
+            memory.insert(memoryKey(path), new QPixmap(QPixmap::fromImage(img)), 1);
+            trimStamps();
+        }
+    }
+
+    if (latest) {
+        latestRunning = false;
+        const QString next = latestNext;
+        latestNext.clear();
+        if (!next.isEmpty()) requestLatest(next, nullptr);
+    }
+    if (stale) schedule(path, false);
+    else if (!img.isNull()) emit thumbnailReady(path);
+}
+
+void ThumbnailCache::invalidate(const QString &path)
+{
+    failed.remove(path);
+    const qint64 mtime = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    if (stamps.value(path, mtime) != mtime) memory.remove(memoryKey(path));
+    stamps.insert(path, mtime);
+}
+
+// Stamps of thumbnails the memory cache has evicted are dead weight.
+void ThumbnailCache::trimStamps()
+{
+    if (stamps.size() <= 2 * memory.maxCost()) return;
+    for (auto it = stamps.begin(); it != stamps.end();) {
+        if (!pending.contains(it.key()) && !memory.contains(memoryKey(it.key()))) it = stamps.erase(it);
+        else ++it;
+    }
+}
+
+// Deletes the least recently used files until the disk cache is back under
+// 3/4 of the budget, on a worker.
+void ThumbnailCache::pruneDisk()
+{
+    if (pruning) return;
+    pruning = true;
+    pool.start([this]() {
+        PROFILE_SCOPE("thumbnail.prune");
+        QFileInfoList files = QDir(diskDirectory()).entryInfoList({ "*.jpg" }, QDir::Files);
+        qint64 total = 0;
+        for (const QFileInfo &fi : qAsConst(files)) total += fi.size();
+
+        if (total > kDiskBudget) {
+            std::sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+                return a.lastModified() < b.lastModified();
+            });
+            for (const QFileInfo &fi : qAsConst(files)) {
+                if (total <= kDiskBudget * 3 / 4) break;
+                if (QFile::remove(fi.filePath())) total -= fi.size();
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, total]() {
+            diskBytes = total;
+            pruning = false;
+        }, Qt::QueuedConnection);
+    }, 0);
+}
+
+void ThumbnailCache::cancelPending()
+{
+    pool.clear();
+    pruning = false;   // a queued prune is dropped too; the next write retries
+    pending.clear();
+    latestRunning = false;
+    latestNext.clear();
+}
@@ -0,0 +1,75 @@
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+// Thumbnails for the filmstrip. Generated in parallel on a worker pool and
+// persisted as small JPEGs under the user cache directory, keyed by
+// path + mtime + size (so a rewritten image gets a new thumbnail). The disk
+// cache is kept under kDiskBudget by dropping the least recently used.
+//
+// Most recent requests are served first: while scrolling quickly the items
+// that just came into view matter more than the ones already scrolled past.
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kSize = 128;   // freedesktop "normal" size
+    static constexpr qint64 kDiskBudget = qint64(512) * 1024 * 1024;
+
+    explicit ThumbnailCache(QObject *parent = nullptr);
+    ~ThumbnailCache() override;
+
+    // Returns the thumbnail if it is in memory; otherwise schedules it and
+    // returns false. thumbnailReady() fires once it is available.
+    bool request(const QString &path, QPixmap *out);
+
+    // Memory lookup only, never schedules work.
+    bool peek(const QString &path, QPixmap *out) const;
+
+    // For slider scrubbing: like request(), but at most one such job runs
+    // and only the newest path waits behind it; paths passed over in the
+    // meantime are never decoded.
+    bool requestLatest(const QString &path, QPixmap *out);
+    void dropLatest();
+
+    // Drops queued (not yet started) jobs, e.g. when the directory changes.
+    void cancelPending();
+
+    // For a file reported added or rewritten: forgets an earlier failure
+    // and the thumbnail of its previous mtime.
+    void invalidate(const QString &path);
+
+    static QString diskPathFor(const QString &path, qint64 mtime, qint64 size);
+    static QString diskDirectory();
+
+signals:
+    void thumbnailReady(const QString &path);
+
+private:
+    void schedule(const QString &path, bool latest);
+    void onGenerated(const QString &path, qint64 mtime, const QImage &img, qint64 written, bool latest);
+    QString memoryKey(const QString &path) const;
+    void pruneDisk();
+    void trimStamps();
+
+    QThreadPool pool;
+    QCache<QString, QPixmap> memory;   // keyed by path + mtime, like the disk cache
+    QHash<QString, qint64> stamps;     // mtime each path's thumbnail was made from
+    QSet<QString> pending;
+    QSet<QString> failed;        // unreadable images, not retried
+    int nextPriority = 0;
+    bool latestRunning = false;
+    QString latestNext;          // waits for the running latest-only job
+    qint64 diskBytes = 0;        // of the disk cache, as of the last prune
+    bool pruning = false;
+};
+
+#endif // THUMBNAILCACHE_H
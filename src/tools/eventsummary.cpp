@@ -0,0 +1,260 @@
+// Throughput report from the structured event log (see eventlog.h).
+//
+//   eventsummary [--idle SECONDS] [--json] [FILE|DIR ...]
+//
+// Without paths the application's own events directory is read. Time
+// between two events of a session only counts as active when the gap is
+// shorter than --idle (default 120 s); longer gaps are breaks.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+struct DirStats {
+    double activeMs = 0;
+    qint64 views = 0;
+    qint64 tags = 0;
+    qint64 images = 0;
+    double scanMs = 0;
+};
+
+struct Totals {
+    int sessions = 0;
+    double activeMs = 0;
+    double wallMs = 0;
+    qint64 views = 0;
+    qint64 tags = 0;
+    qint64 removes = 0;
+    qint64 bulkOps = 0;
+    qint64 bulkFiles = 0;
+    qint64 bulkFailed = 0;
+    double bulkBytes = 0;
+    double bulkMs = 0;
+    QVector<double> dwell;
+    QMap<QString, DirStats> dirs;
+};
+
+struct Session {
+    double firstT = -1;
+    double lastT = -1;
+    QString dir;
+};
+
+double percentile(QVector<double> v, double p)
+{
+    if (v.isEmpty()) return 0;
+    std::sort(v.begin(), v.end());
+    const int i = std::clamp(int(p * (v.size() - 1) + 0.5), 0, int(v.size()) - 1);
+    return v.at(i);
+}
+
+QStringList collectFiles(const QStringList &paths)
+{
+    QStringList files;
+    for (const QString &p : paths) {
+        const QFileInfo fi(p);
+        if (fi.isDir()) {
+            const QDir d(p);
+            for (const QString &name : d.entryList({"events_*.jsonl"}, QDir::Files, QDir::Name))
+                files << d.filePath(name);
+        } else if (fi.isFile()) {
+            files << fi.filePath();
+        }
+    }
+    return files;
+}
+
+void processFile(const QString &path, double idleMs, QHash<QString, Session> &sessions, Totals &t)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot read %s\n", qPrintable(path));
+        return;
+    }
+
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed();
+        if (line.isEmpty()) continue;
+        const QJsonObject o = QJsonDocument::fromJson(line).object();
+        if (o.isEmpty()) continue;
+
+        const QString id = o.value("s").toString();
+        const QString type = o.value("type").toString();
+        const double now = o.value("t").toDouble();
+
+        auto it = sessions.find(id);
+        if (it == sessions.end()) {
+            it = sessions.insert(id, Session());
+            ++t.sessions;
+        }
+        Session &s = it.value();
+
+        if (s.lastT >= 0) {
+            const double gap = now - s.lastT;
+            if (gap > 0 && gap < idleMs) {
+                t.activeMs += gap;
+                if (!s.dir.isEmpty()) t.dirs[s.dir].activeMs += gap;
+            }
+        }
+        if (s.firstT < 0) s.firstT = now;
+        s.lastT = std::max(s.lastT, now);
+
+        if (type == "load_dir") {
+            s.dir = o.value("dir").toString();
+            DirStats &d = t.dirs[s.dir];
+            d.images = std::max<qint64>(d.images, o.value("images").toInt());
+            d.scanMs += o.value("scan_ms").toDouble();
+        } else if (type == "navigate") {
+            ++t.views;
+            if (!s.dir.isEmpty()) ++t.dirs[s.dir].views;
+        } else if (type == "tag") {
+            ++t.tags;
+            if (!s.dir.isEmpty()) ++t.dirs[s.dir].tags;
+            const double dwell = o.value("dwell_ms").toDouble(-1);
+            if (dwell >= 0) t.dwell << dwell;
+        } else if (type == "remove") {
+            t.removes += o.value("count").toInt();
+        } else if (type == "bulk_op") {
+            ++t.bulkOps;
+            t.bulkFiles += o.value("files").toInt();
+            t.bulkFailed += o.value("failed").toInt();
+            t.bulkBytes += o.value("bytes").toDouble();
+            t.bulkMs += o.value("ms").toDouble();
+        }
+    }
+}
+
+double perMinute(qint64 n, double ms)
+{
+    return ms > 0 ? n / (ms / 60000.0) : 0;
+}
+
+QString duration(double ms)
+{
+    const qint64 s = qint64(ms / 1000);
+    return QString("%1:%2:%3").arg(s / 3600).arg((s / 60) % 60, 2, 10, QChar('0')).arg(s % 60, 2, 10, QChar('0'));
+}
+
+void printText(const Totals &t)
+{
+    QTextStream out(stdout);
+    out << "Sessions:          " << t.sessions << "\n"
+        << "Active time:       " << duration(t.activeMs) << " (of " << duration(t.wallMs) << " logged)\n"
+        << "Images viewed:     " << t.views << "  (" << QString::number(perMinute(t.views, t.activeMs), 'f', 1) << "/min active)\n"
+        << "Tags:              " << t.tags << "  (" << QString::number(perMinute(t.tags, t.activeMs), 'f', 1) << "/min active)\n"
+        << "Removed:           " << t.removes << "\n"
+        << "Tag dwell ms:      p50 " << percentile(t.dwell, 0.50)
+        << "  p90 " << percentile(t.dwell, 0.90)
+        << "  p99 " << percentile(t.dwell, 0.99) << "\n"
+        << "Bulk operations:   " << t.bulkOps << " (" << t.bulkFiles << " files, " << t.bulkFailed << " failed, "
+        << QString::number(t.bulkBytes / (1024.0 * 1024.0 * 1024.0), 'f', 2) << " GiB, "
+        << QString::number(t.bulkMs > 0 ? t.bulkBytes / (1024.0 * 1024.0) / (t.bulkMs / 1000.0) : 0, 'f', 1) << " MiB/s)\n\n";
+
+    QStringList dirs = t.dirs.keys();
+    std::sort(dirs.begin(), dirs.end(), [&](const QString &a, const QString &b) {
+        return t.dirs.value(a).activeMs > t.dirs.value(b).activeMs;
+    });
+
+    out << QString("%1 %2 %3 %4 %5  %6\n").arg("active", 10).arg("images", 8).arg("viewed", 8)
+                                             .arg("tags", 8).arg("tags/min", 9).arg("directory");
+    for (const QString &dir : dirs) {
+        const DirStats &d = t.dirs.value(dir);
+        out << QString("%1 %2 %3 %4 %5  %6\n")
+                   .arg(duration(d.activeMs), 10).arg(d.images, 8).arg(d.views, 8).arg(d.tags, 8)
+                   .arg(QString::number(perMinute(d.tags, d.activeMs), 'f', 1), 9).arg(dir);
+    }
+}
+
+void printJson(const Totals &t)
+{
+    QJsonObject o;
+    o["sessions"] = t.sessions;
+    o["active_ms"] = t.activeMs;
+    o["logged_ms"] = t.wallMs;
+    o["views"] = double(t.views);
+    o["tags"] = double(t.tags);
+    o["removes"] = double(t.removes);
+    o["views_per_min"] = perMinute(t.views, t.activeMs);
+    o["tags_per_min"] = perMinute(t.tags, t.activeMs);
+    o["dwell_p50_ms"] = percentile(t.dwell, 0.50);
+    o["dwell_p90_ms"] = percentile(t.dwell, 0.90);
+    o["dwell_p99_ms"] = percentile(t.dwell, 0.99);
+    o["bulk_ops"] = double(t.bulkOps);
+    o["bulk_files"] = double(t.bulkFiles);
+    o["bulk_failed"] = double(t.bulkFailed);
+    o["bulk_bytes"] = t.bulkBytes;
+    o["bulk_ms"] = t.bulkMs;
+
+    QJsonArray dirs;
+    for (auto it = t.dirs.constBegin(); it != t.dirs.constEnd(); ++it) {
+        QJsonObject d;
+        d["dir"] = it.key();
+        d["active_ms"] = it->activeMs;
+        d["images"] = double(it->images);
+        d["views"] = double(it->views);
+        d["tags"] = double(it->tags);
+        d["tags_per_min"] = perMinute(it->tags, it->activeMs);
+        d["scan_ms"] = it->scanMs;
+        dirs.append(d);
+    }
+    o["directories"] = dirs;
+
+    std::fputs(QJsonDocument(o).toJson(QJsonDocument::Indented).constData(), stdout);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("AI_ImageSuite");
+    app.setApplicationName("AI_ImageSuite");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Summarizes AI_ImageSuite event logs into a throughput report.");
+    parser.addHelpOption();
+    QCommandLineOption idleOpt("idle", "Gaps longer than this many seconds are breaks.", "seconds", "120");
+    QCommandLineOption jsonOpt("json", "Print the report as JSON.");
+    parser.addOption(idleOpt);
+    parser.addOption(jsonOpt);
+    parser.addPositionalArgument("paths", "Event files or directories.", "[paths...]");
+    parser.process(app);
+
+    QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty())
+        paths << QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("events");
+
+    const QStringList files = collectFiles(paths);
+    if (files.isEmpty()) {
+        std::fprintf(stderr, "no event files found\n");
+        return 1;
+    }
+
+    const double idleMs = parser.value(idleOpt).toDouble() * 1000.0;
+    QHash<QString, Session> sessions;
+    Totals totals;
+    for (const QString &f : files) processFile(f, idleMs, sessions, totals);
+
+    for (const Session &s : qAsConst(sessions)) {
+        if (s.firstT >= 0) totals.wallMs += s.lastT - s.firstT;
+    }
+
+    if (parser.isSet(jsonOpt)) printJson(totals);
+    else                       printText(totals);
+    return 0;
+}
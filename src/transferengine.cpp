@@ -0,0 +1,653 @@
+#include "transferengine.h"
+#include "profiler.h"
+#include "yololabels.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#ifndef RENAME_NOREPLACE
+#define RENAME_NOREPLACE (1 << 0)
+#endif
+#endif
+
+namespace {
+const qint64 kChunk = qint64(8) * 1024 * 1024;
+const qint64 kCompareChunk = 1024 * 1024;
+const int kMaxCollisionSuffix = 9999;
+
+enum class Place { Ok, Exists, Failed };
+
+// Unique per unit: same-named sources from different folders may be
+// copied into one destination at the same time.
+QString tempPathFor(const QString &dst, int unit)
+{
+    const QFileInfo fi(dst);
+    return fi.dir().filePath(QString(".%1.%2-%3.part")
+                             .arg(fi.fileName())
+                             .arg(QCoreApplication::applicationPid())
+                             .arg(unit));
+}
+
+// Streams both files in fixed-size chunks; memory use is independent of
+// the file size.
+bool sameContents(const QString &a, const QString &b)
+{
+    QFile fa(a), fb(b);
+    if (!fa.open(QIODevice::ReadOnly) || !fb.open(QIODevice::ReadOnly)) return false;
+    if (fa.size() != fb.size()) return false;
+
+    while (!fa.atEnd()) {
+        const QByteArray ca = fa.read(kCompareChunk);
+        const QByteArray cb = fb.read(kCompareChunk);
+        if (ca.isEmpty() || ca != cb) return false;
+    }
+    return fb.atEnd();
+}
+
+#ifdef Q_OS_UNIX
+QString errnoString()
+{
+    return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+// Copies `size` bytes between descriptors, preferring in-kernel paths.
+bool copyDescriptors(int in, int out, qint64 size, const std::atomic<bool> &cancel,
+                     std::atomic<qint64> &done, QString *error, QString *method)
+{
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    // Reflink: instant on btrfs/xfs/bcachefs when both are on one filesystem.
+    if (::ioctl(out, FICLONE, in) == 0) {
+        *method = "reflink";
+        done += size;
+        return true;
+    }
+#endif
+
+    qint64 copied = 0;
+#ifdef Q_OS_LINUX
+    bool kernelCopy = true;
+    bool useSendfile = false;
+    while (kernelCopy && copied < size) {
+        if (cancel.load()) return false;
+        const size_t want = size_t(std::min(kChunk, size - copied));
+        ssize_t n = -1;
+#ifdef SYS_copy_file_range
+        if (!useSendfile) {
+            n = ::syscall(SYS_copy_file_range, in, nullptr, out, nullptr, want, 0u);
+            if (n < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                useSendfile = true;
+                continue;
+            }
+            *method = "copy_file_range";
+        } else
+#endif
+        {
+            n = ::sendfile(out, in, nullptr, want);
+            if (n < 0 && (errno == ENOSYS || errno == EINVAL)) {
+                kernelCopy = false;
+                break;
+            }
+            *method = "sendfile";
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            *error = errnoString();
+            return false;
+        }
+        if (n == 0) break;   // source shrank
+        copied += n;
+        done += n;
+    }
+    if (copied >= size) return true;
+#endif
+
+    // Portable fallback from wherever the kernel path stopped.
+    *method = "readwrite";
+    if (::lseek(in, copied, SEEK_SET) < 0 || ::lseek(out, copied, SEEK_SET) < 0) {
+        *error = errnoString();
+        return false;
+    }
+    QByteArray buf(int(kCompareChunk), Qt::Uninitialized);
+    for (;;) {
+        if (cancel.load()) return false;
+        const ssize_t n = ::read(in, buf.data(), size_t(buf.size()));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            *error = errnoString();
+            return false;
+        }
+        if (n == 0) return true;
+        for (ssize_t off = 0; off < n;) {
+            const ssize_t w = ::write(out, buf.constData() + off, size_t(n - off));
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) {
+                *error = errnoString();
+                return false;
+            }
+            off += w;
+        }
+        done += n;
+    }
+}
+
+// Writes a copy of `src` to `tmp`; with `durable` the data is on disk
+// before this returns.
+bool copyToTemp(const QString &src, const QString &tmp, bool durable, const std::atomic<bool> &cancel,
+                std::atomic<qint64> &done, QString *error, QString *method)
+{
+    const QByteArray tmpPath = QFile::encodeName(tmp);
+
+    const int in = ::open(QFile::encodeName(src).constData(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        *error = errnoString();
+        return false;
+    }
+    struct stat st;
+    if (::fstat(in, &st) != 0) {
+        *error = errnoString();
+        ::close(in);
+        return false;
+    }
+    const int out = ::open(tmpPath.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777);
+    if (out < 0) {
+        *error = errnoString();
+        ::close(in);
+        return false;
+    }
+
+    bool ok = copyDescriptors(in, out, qint64(st.st_size), cancel, done, error, method);
+    if (ok && durable && ::fdatasync(out) != 0) {
+        *error = errnoString();
+        ok = false;
+    }
+    ::close(in);
+    if (::close(out) != 0 && ok) {
+        *error = errnoString();
+        ok = false;
+    }
+    if (!ok) {
+        ::unlink(tmpPath.constData());
+        if (error->isEmpty() && cancel.load()) *error = "cancelled";
+    }
+    return ok;
+}
+
+// Renames without ever replacing `to`.
+Place renameNoReplace(const QString &from, const QString &to, QString *error)
+{
+    const QByteArray a = QFile::encodeName(from);
+    const QByteArray b = QFile::encodeName(to);
+
+#if defined(Q_OS_LINUX) && defined(SYS_renameat2)
+    if (::syscall(SYS_renameat2, AT_FDCWD, a.constData(), AT_FDCWD, b.constData(), RENAME_NOREPLACE) == 0)
+        return Place::Ok;
+    if (errno == EEXIST) return Place::Exists;
+    if (errno != EINVAL && errno != ENOSYS) {
+        *error = errnoString();
+        return Place::Failed;
+    }
+#endif
+
+    // link() fails atomically on an existing name; not every filesystem
+    // supports it, in which case only the existence check guards `to`.
+    if (::link(a.constData(), b.constData()) == 0) {
+        ::unlink(a.constData());
+        return Place::Ok;
+    }
+    if (errno == EEXIST) return Place::Exists;
+    if (::access(b.constData(), F_OK) == 0) return Place::Exists;
+    if (::rename(a.constData(), b.constData()) == 0) return Place::Ok;
+    *error = errnoString();
+    return Place::Failed;
+}
+
+void syncDirectory(const QString &dir)
+{
+    const int fd = ::open(QFile::encodeName(dir).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+bool removeFile(const QString &path)
+{
+    return ::unlink(QFile::encodeName(path).constData()) == 0;
+}
+#else
+bool copyToTemp(const QString &src, const QString &tmp, bool durable, const std::atomic<bool> &cancel,
+                std::atomic<qint64> &done, QString *error, QString *method)
+{
+    *method = "readwrite";
+    QFile in(src);
+    if (!in.open(QIODevice::ReadOnly)) {
+        *error = in.errorString();
+        return false;
+    }
+    QFile out(tmp);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = out.errorString();
+        return false;
+    }
+
+    bool ok = true;
+    while (ok && !in.atEnd()) {
+        if (cancel.load()) {
+            *error = "cancelled";
+            ok = false;
+            break;
+        }
+        const QByteArray chunk = in.read(kChunk);
+        ok = out.write(chunk) == chunk.size();
+        if (!ok) *error = out.errorString();
+        done += chunk.size();
+    }
+    if (ok && durable) ok = out.flush();
+    out.close();
+    if (!ok) QFile::remove(tmp);
+    return ok;
+}
+
+// QFile::rename() refuses to replace an existing file.
+Place renameNoReplace(const QString &from, const QString &to, QString *error)
+{
+    if (QFile::rename(from, to)) return Place::Ok;
+    if (QFileInfo::exists(to)) return Place::Exists;
+    *error = "rename failed";
+    return Place::Failed;
+}
+
+void syncDirectory(const QString &)
+{
+}
+
+bool removeFile(const QString &path)
+{
+    return QFile::remove(path);
+}
+#endif
+
+// Moves `from` into `destDir` as `fileName`, or as "<base>_N.<suffix>" if
+// that name holds a different file. An identical file already there
+// consumes `from` instead. With a `label` coming along, a name whose
+// "<base>.txt" is taken by another image's label (a.png next to a.jpg) is
+// skipped too, and an identical image only counts if its label is
+// identical or missing.
+bool placeFile(const QString &from, const QDir &destDir, const QString &fileName, const QString &label,
+               QString *finalPath, bool *identical, QString *error)
+{
+    const QFileInfo name(fileName);
+    const QString suffix = name.suffix().isEmpty() ? QString() : "." + name.suffix();
+
+    *identical = false;
+    for (int n = 0; n <= kMaxCollisionSuffix; ++n) {
+        const QString base = n == 0 ? name.completeBaseName() : QString("%1_%2").arg(name.completeBaseName()).arg(n);
+        const QString candidate = destDir.filePath(base + suffix);
+        const QString candidateLabel = YoloLabels::labelPathFor(candidate);
+        if (!label.isEmpty() && QFileInfo::exists(candidateLabel) && !QFileInfo::exists(candidate))
+            continue;
+
+        switch (renameNoReplace(from, candidate, error)) {
+        case Place::Ok:
+            *finalPath = candidate;
+            return true;
+        case Place::Failed:
+            return false;
+        case Place::Exists:
+            if (!label.isEmpty() && QFileInfo::exists(candidateLabel) && !sameContents(label, candidateLabel))
+                break;
+            if (sameContents(from, candidate)) {
+                removeFile(from);
+                *finalPath = candidate;
+                *identical = true;
+                return true;
+            }
+            break;
+        }
+    }
+    *error = "no free name";
+    return false;
+}
+
+// Places a label next to its placed image without replacing anything; an
+// identical label already there consumes `from`.
+bool placeLabel(const QString &from, const QString &to, bool *identical, QString *error)
+{
+    switch (renameNoReplace(from, to, error)) {
+    case Place::Ok:
+        return true;
+    case Place::Failed:
+        return false;
+    case Place::Exists:
+        break;
+    }
+    if (sameContents(from, to)) {
+        removeFile(from);
+        *identical = true;
+        return true;
+    }
+    *error = "label exists";
+    return false;
+}
+}
+
+TransferEngine::TransferEngine(QObject *parent)
+    : QObject(parent)
+    , cancelFlag(std::make_shared<std::atomic<bool>>(false))
+    , doneBytes(std::make_shared<std::atomic<qint64>>(0))
+{
+    pool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 2, 8));
+
+    progressTimer = new QTimer(this);
+    progressTimer->setInterval(200);
+    connect(progressTimer, &QTimer::timeout, this, &TransferEngine::progress);
+}
+
+TransferEngine::~TransferEngine()
+{
+    cancelFlag->store(true);
+    pool.clear();
+    pool.waitForDone();
+}
+
+quint64 TransferEngine::deviceOf(const QString &dir)
+{
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if (::stat(QFile::encodeName(dir).constData(), &st) == 0) return quint64(st.st_dev);
+#else
+    // Drive / share root; good enough to group work per volume.
+    const QString root = QFileInfo(dir).absoluteFilePath().section('/', 0, 0);
+    return qHash(root.toLower());
+#endif
+    return 0;
+}
+
+int TransferEngine::concurrencyFor(quint64 device)
+{
+#ifdef Q_OS_LINUX
+    // Whole disks expose queue/ directly, partitions through their parent.
+    const QString base = QString("/sys/dev/block/%1:%2/").arg(major(dev_t(device))).arg(minor(dev_t(device)));
+    for (const QString &rel : {QStringLiteral("queue/rotational"), QStringLiteral("../queue/rotational")}) {
+        QFile f(base + rel);
+        if (f.open(QIODevice::ReadOnly)) return f.readAll().trimmed() == "1" ? 1 : 4;
+    }
+#else
+    Q_UNUSED(device);
+#endif
+    return 2;   // network / virtual filesystems, unknown
+}
+
+bool TransferEngine::start(const QVector<Item> &items, Mode m)
+{
+    if (isRunning()) return false;
+
+    mode = m;
+    units.clear();
+    results.clear();
+    pendingDevices.clear();
+    activePerDevice.clear();
+    limitPerDevice.clear();
+    destDirsToSync.clear();
+    sourceDirsToSync.clear();
+    sourcesToUnlink.clear();
+    totalBytes = 0;
+    cancelFlag->store(false);
+    doneBytes->store(0);
+
+    report.close();
+    if (!reportPath.isEmpty()) {
+        QDir().mkpath(QFileInfo(reportPath).absolutePath());
+        report.setFileName(reportPath);
+        report.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+
+    QHash<QString, quint64> dirDevice;
+    auto deviceCached = [&](const QString &dir) {
+        auto it = dirDevice.constFind(dir);
+        if (it == dirDevice.constEnd()) it = dirDevice.insert(dir, deviceOf(dir));
+        return it.value();
+    };
+
+    units.reserve(items.size());
+    for (const Item &item : items) {
+        Unit u;
+        u.index = units.size();
+        u.item = item;
+        u.bytes = QFileInfo(item.source).size() + QFileInfo(YoloLabels::labelPathFor(item.source)).size();
+        u.device = deviceCached(item.destDir);
+        u.sameDevice = u.device != 0 && u.device == deviceCached(QFileInfo(item.source).absolutePath());
+
+        totalBytes += u.bytes;
+        units << u;
+    }
+
+    // Queues are popped from the back; keep the selection order.
+    for (int i = units.size() - 1; i >= 0; --i) {
+        const quint64 dev = units.at(i).device;
+        pendingDevices[dev] << i;
+        if (!limitPerDevice.contains(dev)) limitPerDevice.insert(dev, concurrencyFor(dev));
+    }
+
+    clock.start();
+    progressTimer->start();
+    dispatch();
+    if (running == 0) finalize();
+    return true;
+}
+
+void TransferEngine::cancel()
+{
+    if (!isRunning() || finalizing) return;
+    cancelFlag->store(true);
+    pendingDevices.clear();
+    if (running == 0) finalize();
+}
+
+void TransferEngine::dispatch()
+{
+    for (auto it = pendingDevices.begin(); it != pendingDevices.end();) {
+        const quint64 dev = it.key();
+        int &active = activePerDevice[dev];
+        while (active < limitPerDevice.value(dev, 2) && !it.value().isEmpty()) {
+            const int index = it.value().takeLast();
+            ++active;
+            ++running;
+
+            const Unit unit = units.at(index);
+            const Mode m = mode;
+            auto cancelRef = cancelFlag;
+            auto doneRef = doneBytes;
+            pool.start([this, index, unit, m, cancelRef, doneRef]() {
+                const Result r = runUnit(unit, m, *cancelRef, *doneRef);
+                QMetaObject::invokeMethod(this, [this, index, r]() {
+                    onUnitDone(index, r);
+                }, Qt::QueuedConnection);
+            });
+        }
+        if (it.value().isEmpty()) it = pendingDevices.erase(it);
+        else ++it;
+    }
+}
+
+void TransferEngine::onUnitDone(int index, const Result &result)
+{
+    --running;
+    --activePerDevice[units.at(index).device];
+
+    if (result.ok) {
+        destDirsToSync.insert(QFileInfo(result.destination).absolutePath());
+        if (mode == Mode::Move) sourceDirsToSync.insert(QFileInfo(result.source).absolutePath());
+        sourcesToUnlink += result.unlinkAfterSync;
+    }
+
+    results << result;
+    writeReport(result);
+    emit itemFinished(result);
+
+    if (!cancelFlag->load()) dispatch();
+    if (running == 0 && pendingDevices.isEmpty()) finalize();
+}
+
+void TransferEngine::finalize()
+{
+    // Destination entries must be durable before cross-device sources go.
+    finalizing = true;
+    const QStringList destDirs = destDirsToSync.values();
+    const QStringList sourceDirs = sourceDirsToSync.values();
+    const QStringList unlinks = sourcesToUnlink;
+
+    pool.start([this, destDirs, sourceDirs, unlinks]() {
+        PROFILE_SCOPE("transfer.finalize");
+        for (const QString &d : destDirs) syncDirectory(d);
+
+        QStringList failed;
+        for (const QString &f : unlinks) {
+            if (!removeFile(f)) failed << f;
+        }
+        for (const QString &d : sourceDirs) syncDirectory(d);
+
+        QMetaObject::invokeMethod(this, [this, failed]() {
+            onFinalized(failed);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TransferEngine::onFinalized(const QStringList &unlinkFailures)
+{
+    for (const QString &f : unlinkFailures) {
+        QJsonObject o;
+        o["op"] = "unlink";
+        o["source"] = f;
+        o["ok"] = false;
+        if (report.isOpen()) report.write(QJsonDocument(o).toJson(QJsonDocument::Compact) + '\n');
+    }
+    report.close();
+
+    finalizing = false;
+    progressTimer->stop();
+    emit progress();
+    emit finished(cancelFlag->load());
+}
+
+void TransferEngine::writeReport(const Result &r)
+{
+    if (!report.isOpen()) return;
+
+    QJsonObject o;
+    o["op"] = mode == Mode::Copy ? "copy" : "move";
+    o["source"] = r.source;
+    o["destination"] = r.destination;
+    o["category"] = r.category;
+    o["method"] = r.method;
+    o["bytes"] = double(r.bytes);
+    o["ms"] = double(r.elapsedMs);
+    o["ok"] = r.ok;
+    o["verified"] = r.verified;
+    o["label"] = !r.hasLabel ? "none" : r.labelOk ? (r.labelIdentical ? "identical" : "ok") : "failed";
+    if (!r.error.isEmpty()) o["error"] = r.error;
+    report.write(QJsonDocument(o).toJson(QJsonDocument::Compact) + '\n');
+}
+
+TransferEngine::Result TransferEngine::runUnit(const Unit &unit, Mode mode,
+                                               const std::atomic<bool> &cancel, std::atomic<qint64> &done)
+{
+    PROFILE_SCOPE("transfer.unit");
+    QElapsedTimer timer;
+    timer.start();
+
+    Result r;
+    r.source = unit.item.source;
+    r.category = unit.item.category;
+    r.bytes = unit.bytes;
+
+    const QFileInfo fi(unit.item.source);
+    const QDir destDir(unit.item.destDir);
+    const bool move = mode == Mode::Move;
+    const bool rename = move && unit.sameDevice;
+
+    if (cancel.load()) {
+        r.error = "cancelled";
+        return r;
+    }
+    if (!fi.exists()) {
+        r.error = "source missing";
+        return r;
+    }
+
+    const QString srcTxt = YoloLabels::labelPathFor(r.source);
+    r.hasLabel = QFileInfo::exists(srcTxt);
+    const QString label = r.hasLabel ? srcTxt : QString();
+
+    bool identical = false;
+    if (rename) {
+        r.method = "rename";
+        const qint64 size = fi.size();
+        r.ok = placeFile(r.source, destDir, fi.fileName(), label, &r.destination, &identical, &r.error);
+        if (r.ok) done += size;
+    } else {
+        // Moves across filesystems keep the source until the copy is on
+        // disk and compared.
+        const QString tmp = tempPathFor(destDir.filePath(fi.fileName()), unit.index);
+        r.ok = copyToTemp(r.source, tmp, move, cancel, done, &r.error, &r.method);
+        if (r.ok && move) {
+            r.verified = sameContents(r.source, tmp);
+            if (!r.verified) {
+                r.ok = false;
+                r.error = "verification failed";
+            }
+        }
+        if (r.ok) r.ok = placeFile(tmp, destDir, fi.fileName(), label, &r.destination, &identical, &r.error);
+        if (!r.ok) removeFile(tmp);
+        if (r.ok && move) r.unlinkAfterSync << r.source;
+    }
+    if (identical) r.method = "identical";
+    if (!r.ok) {
+        r.elapsedMs = timer.elapsed();
+        return r;
+    }
+
+    // The label follows its image (and its final name) even if a cancel
+    // arrives meanwhile. It never replaces a label already there: that
+    // one belongs to another image, unless it is identical.
+    if (r.hasLabel) {
+        const QString dstTxt = YoloLabels::labelPathFor(r.destination);
+
+        QString labelError;
+        if (rename) {
+            r.labelOk = placeLabel(srcTxt, dstTxt, &r.labelIdentical, &labelError);
+        } else {
+            const std::atomic<bool> never(false);
+            const QString tmp = tempPathFor(dstTxt, unit.index);
+            QString method;
+            r.labelOk = copyToTemp(srcTxt, tmp, move, never, done, &labelError, &method)
+                        && (!move || sameContents(srcTxt, tmp))
+                        && placeLabel(tmp, dstTxt, &r.labelIdentical, &labelError);
+            if (!r.labelOk) removeFile(tmp);
+            if (r.labelOk && move) r.unlinkAfterSync << srcTxt;
+        }
+    }
+
+    r.elapsedMs = timer.elapsed();
+    return r;
+}
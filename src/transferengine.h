@@ -0,0 +1,143 @@
+#ifndef TRANSFERENGINE_H
+#define TRANSFERENGINE_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class QTimer;
+
+// Copies or moves images, together with their YOLO .txt, on a worker pool.
+//
+// Work is queued per destination device and each device only gets as many
+// concurrent transfers as it handles well (one for spinning disks), so a
+// slow USB drive does not starve a local SSD and vice versa. File data is
+// copied in the kernel where possible (reflink, copy_file_range, sendfile)
+// into a temporary name that is renamed into place, so a cancelled or
+// failed copy never leaves a truncated image behind.
+//
+// Moves within one filesystem are plain renames. Moves across filesystems
+// copy, fdatasync and verify the data; the sources are only unlinked at
+// the end, after every destination directory has been fsynced once. The
+// touched directories are fsynced once per run rather than once per file.
+//
+// Name collisions never replace an existing image: an identical file counts
+// as already transferred, a different one gets a "_N" suffix (the label
+// follows the image's final name).
+//
+// An image and its label form one unit: cancellation stops between units
+// or aborts the image copy, never between an image and its label.
+class TransferEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode { Copy, Move };
+
+    struct Item {
+        QString source;          // image path
+        QString destDir;
+        QString category;
+    };
+
+    struct Result {
+        QString source;
+        QString destination;     // final path, may carry a collision suffix
+        QString category;
+        QString method;          // rename, reflink, copy_file_range, sendfile, readwrite, identical
+        qint64 bytes = 0;
+        qint64 elapsedMs = 0;
+        bool ok = false;
+        bool verified = false;   // contents compared after a cross-device copy
+        bool hasLabel = false;
+        bool labelOk = true;     // false if the .txt existed but failed
+        bool labelIdentical = false;   // same label already there, source consumed
+        QString error;
+        QStringList unlinkAfterSync;   // sources of a cross-device move
+    };
+
+    explicit TransferEngine(QObject *parent = nullptr);
+    ~TransferEngine() override;
+
+    // One JSON object per file is appended to `path` during each run
+    // (empty disables the report).
+    void setReportPath(const QString &path) { reportPath = path; }
+    QString lastReportPath() const { return report.fileName(); }
+
+    // Returns false if a transfer is already running.
+    bool start(const QVector<Item> &items, Mode mode);
+    void cancel();
+
+    bool isRunning() const { return running > 0 || finalizing || !pendingDevices.isEmpty(); }
+    bool wasCancelled() const { return cancelFlag->load(); }
+
+    qint64 bytesTotal() const { return totalBytes; }
+    qint64 bytesDone() const { return doneBytes->load(); }
+    int filesTotal() const { return units.size(); }
+    int filesDone() const { return results.size(); }
+    qint64 elapsedMs() const { return clock.elapsed(); }
+
+    const QVector<Result> &finishedResults() const { return results; }
+
+signals:
+    void progress();
+    void itemFinished(const TransferEngine::Result &result);
+    void finished(bool cancelled);
+
+private:
+    struct Unit {
+        int index = 0;           // in `units`; names the temp files
+        Item item;
+        quint64 device = 0;      // of destDir
+        bool sameDevice = false;
+        qint64 bytes = 0;
+    };
+
+    static Result runUnit(const Unit &unit, Mode mode,
+                          const std::atomic<bool> &cancel, std::atomic<qint64> &done);
+    static quint64 deviceOf(const QString &dir);
+    static int concurrencyFor(quint64 device);
+
+    void dispatch();
+    void onUnitDone(int index, const Result &result);
+    void finalize();
+    void onFinalized(const QStringList &unlinkFailures);
+    void writeReport(const Result &result);
+
+    QThreadPool pool;
+    QTimer *progressTimer = nullptr;
+    QElapsedTimer clock;
+
+    Mode mode = Mode::Copy;
+    QVector<Unit> units;
+    QVector<Result> results;
+    qint64 totalBytes = 0;
+
+    QHash<quint64, QVector<int>> pendingDevices;   // device -> unit indices (back = next)
+    QHash<quint64, int> activePerDevice;
+    QHash<quint64, int> limitPerDevice;
+    int running = 0;
+    bool finalizing = false;
+
+    // Deferred until the end of the run.
+    QSet<QString> destDirsToSync;
+    QSet<QString> sourceDirsToSync;
+    QStringList sourcesToUnlink;
+
+    QString reportPath;
+    QFile report;
+
+    std::shared_ptr<std::atomic<bool>> cancelFlag;
+    std::shared_ptr<std::atomic<qint64>> doneBytes;
+};
+
+#endif // TRANSFERENGINE_H
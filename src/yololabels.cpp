@@ -0,0 +1,121 @@
+#include "yololabels.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QLocale>
+
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p < end && isSpace(*p)) ++p;
+    return p;
+}
+
+inline const char *tokenEnd(const char *p, const char *end)
+{
+    while (p < end && !isSpace(*p)) ++p;
+    return p;
+}
+
+// A whole token must convert, like QString::toInt()/toDouble() did.
+template <typename T>
+bool parseNumber(const char *b, const char *e, T &value)
+{
+    if (b < e && *b == '+') ++b;   // from_chars rejects a leading '+'
+    if (b == e) return false;
+
+#if defined(__cpp_lib_to_chars)
+    const auto r = std::from_chars(b, e, value);
+    return r.ec == std::errc() && r.ptr == e;
+#else
+    // Fallback for standard libraries without floating-point from_chars.
+    bool ok = false;
+    const QString s = QString::fromLatin1(b, int(e - b));
+    if constexpr (std::is_integral_v<T>) value = T(QLocale::c().toInt(s, &ok));
+    else value = T(QLocale::c().toDouble(s, &ok));
+    return ok;
+#endif
+}
+
+} // namespace
+
+namespace YoloLabels {
+
+QString labelPathFor(const QString &imagePath)
+{
+    const QFileInfo fi(imagePath);
+    return fi.dir().filePath(fi.completeBaseName() + ".txt");
+}
+
+int parse(const char *begin, const char *end, QVector<YoloLabel> &out)
+{
+    out.clear();
+
+    const char *p = begin;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!lineEnd) lineEnd = end;
+
+        // Split the line into at most six tokens; extra columns are ignored.
+        const char *tb[6];
+        const char *te[6];
+        int n = 0;
+        const char *q = skipSpaces(p, lineEnd);
+        while (q < lineEnd && n < 6) {
+            tb[n] = q;
+            te[n] = tokenEnd(q, lineEnd);
+            q = skipSpaces(te[n], lineEnd);
+            ++n;
+        }
+        p = lineEnd + 1;
+
+        if (n < 5) continue;
+
+        YoloLabel l;
+        double xc = 0, yc = 0, w = 0, h = 0, conf = 1;
+        if (!parseNumber(tb[0], te[0], l.classId)) continue;
+        if (!parseNumber(tb[1], te[1], xc)) continue;
+        if (!parseNumber(tb[2], te[2], yc)) continue;
+        if (!parseNumber(tb[3], te[3], w)) continue;
+        if (!parseNumber(tb[4], te[4], h)) continue;
+        if (n >= 6 && !parseNumber(tb[5], te[5], conf)) continue;
+
+        l.xCenter = float(xc);
+        l.yCenter = float(yc);
+        l.width = float(w);
+        l.height = float(h);
+        l.confidence = float(conf);
+        l.hasConfidence = n >= 6;
+        out.push_back(l);
+    }
+    return out.size();
+}
+
+bool readFile(const QString &txtPath, QByteArray &buffer, QVector<YoloLabel> &out)
+{
+    out.clear();
+
+    QFile f(txtPath);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = f.size();
+    buffer.resize(int(size));
+    const qint64 got = size > 0 ? f.read(buffer.data(), size) : 0;
+    if (got < 0) return false;
+
+    parse(buffer.constData(), buffer.constData() + got, out);
+    return true;
+}
+
+} // namespace YoloLabels
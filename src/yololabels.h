@@ -0,0 +1,38 @@
+#ifndef YOLOLABELS_H
+#define YOLOLABELS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// One line of a darknet/YOLO label file, in normalized [0,1] coordinates.
+struct YoloLabel {
+    int classId = -1;
+    float xCenter = 0.0f;
+    float yCenter = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float confidence = 1.0f;   // optional 6th column; 1 if absent (ground truth)
+    bool hasConfidence = false;
+};
+
+// Parser for `<class> <xc> <yc> <w> <h> [conf]` label files. Works on the raw
+// bytes with std::from_chars, so parsing does not allocate once the caller's
+// buffers have grown to size. Every code path that reads .txt labels goes
+// through here.
+namespace YoloLabels {
+
+// <dir>/<completeBaseName>.txt for an image path.
+QString labelPathFor(const QString &imagePath);
+
+// Parses `[begin, end)` into `out` (cleared first, capacity kept).
+// Malformed lines are skipped, as are lines with fewer than five fields.
+int parse(const char *begin, const char *end, QVector<YoloLabel> &out);
+
+// Reads `txtPath` in one go into `buffer` and parses it. Returns false if the
+// file does not exist or cannot be read; `out` is cleared either way.
+bool readFile(const QString &txtPath, QByteArray &buffer, QVector<YoloLabel> &out);
+
+} // namespace YoloLabels
+
+#endif // YOLOLABELS_H